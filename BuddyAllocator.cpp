@@ -0,0 +1,121 @@
+#include "BuddyAllocator.h"
+#include <algorithm>
+
+BuddyAllocator::BuddyAllocator(size_t totalSize)
+    : IFlatAllocator(BUDDY, totalSize), maxOrder(MIN_ORDER)
+{
+    // max-overall-mem is validated as a power of two
+    while ((size_t(1) << (maxOrder + 1)) <= totalSize)
+    {
+        ++maxOrder;
+    }
+
+    freeLists.resize(maxOrder - MIN_ORDER + 1);
+    freeLists[maxOrder - MIN_ORDER].insert(0);
+}
+
+int BuddyAllocator::orderFor(size_t size) const
+{
+    int order = MIN_ORDER;
+    while ((size_t(1) << order) < size)
+    {
+        ++order;
+    }
+    return order;
+}
+
+bool BuddyAllocator::allocate(size_t size, size_t &address, size_t &blockSize)
+{
+    int order = orderFor(size);
+    if (order > maxOrder)
+        return false;
+
+    // Smallest order with a free block
+    int available = order;
+    while (available <= maxOrder && freeLists[available - MIN_ORDER].empty())
+    {
+        ++available;
+    }
+    if (available > maxOrder)
+        return false;
+
+    auto &list = freeLists[available - MIN_ORDER];
+    size_t block = *list.begin();
+    list.erase(list.begin());
+
+    // Split down, returning each upper half to the free list of its order
+    while (available > order)
+    {
+        --available;
+        freeLists[available - MIN_ORDER].insert(block + (size_t(1) << available));
+    }
+
+    allocatedOrders[block] = order;
+    address = block;
+    blockSize = size_t(1) << order;
+    return true;
+}
+
+void BuddyAllocator::release(size_t address)
+{
+    auto it = allocatedOrders.find(address);
+    if (it == allocatedOrders.end())
+        return;
+
+    int order = it->second;
+    allocatedOrders.erase(it);
+
+    // Merge with the buddy for as long as it is free
+    while (order < maxOrder)
+    {
+        size_t buddy = address ^ (size_t(1) << order);
+        if (freeLists[order - MIN_ORDER].erase(buddy) == 0)
+            break;
+
+        address = std::min(address, buddy);
+        ++order;
+    }
+
+    freeLists[order - MIN_ORDER].insert(address);
+}
+
+size_t BuddyAllocator::getFreeBlockCount() const
+{
+    size_t count = 0;
+    for (const auto &list : freeLists)
+    {
+        count += list.size();
+    }
+    return count;
+}
+
+void BuddyAllocator::getBlocks(std::vector<FlatBlock> &blocks) const
+{
+    blocks.clear();
+    for (int order = MIN_ORDER; order <= maxOrder; ++order)
+    {
+        for (size_t address : freeLists[order - MIN_ORDER])
+        {
+            blocks.push_back({address, size_t(1) << order, true});
+        }
+    }
+    for (const auto &pair : allocatedOrders)
+    {
+        blocks.push_back({pair.first, size_t(1) << pair.second, false});
+    }
+
+    std::sort(blocks.begin(), blocks.end(), [](const FlatBlock &a, const FlatBlock &b)
+              { return a.address < b.address; });
+}
+
+size_t BuddyAllocator::getLargestFreeBlock() const
+{
+    for (int order = maxOrder; order >= MIN_ORDER; --order)
+    {
+        if (!freeLists[order - MIN_ORDER].empty())
+        {
+            return size_t(1) << order;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef BUDDY_ALLOCATOR_H
+#define BUDDY_ALLOCATOR_H
+
+#include "IFlatAllocator.h"
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Binary buddy system over a power-of-two arena; blocks are 2^order bytes
+class BuddyAllocator : public IFlatAllocator
+{
+public:
+    BuddyAllocator(size_t totalSize);
+
+    bool allocate(size_t size, size_t &address, size_t &blockSize) override;
+    void release(size_t address) override;
+    std::string getName() const override { return "buddy"; }
+
+    size_t getFreeBlockCount() const override;
+    size_t getLargestFreeBlock() const override;
+    void getBlocks(std::vector<FlatBlock> &blocks) const override;
+
+private:
+    static const int MIN_ORDER = 10; // 1KB, below min-mem-per-proc
+
+    int maxOrder;
+    std::vector<std::set<size_t>> freeLists;              // Indexed by order - MIN_ORDER, address ordered
+    std::unordered_map<size_t, int> allocatedOrders;      // Block address to order
+
+    int orderFor(size_t size) const;
+};
+
+#endif
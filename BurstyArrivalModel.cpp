@@ -0,0 +1,28 @@
+#include "BurstyArrivalModel.h"
+#include <algorithm>
+
+BurstyArrivalModel::BurstyArrivalModel(uint32_t batchFreq, uint32_t onCycles, uint32_t offCycles)
+    : onCycles(onCycles), period(static_cast<uint64_t>(onCycles) + offCycles)
+{
+    burstRate = static_cast<double>(period) / (static_cast<double>(onCycles) * batchFreq);
+}
+
+uint64_t BurstyArrivalModel::arrivals(uint64_t from, uint64_t to)
+{
+    return samplePoisson((burstCyclesThrough(to) - burstCyclesThrough(from)) * burstRate);
+}
+
+// Gaps are drawn in burst time and mapped back, so the idle part of each
+// period is skipped
+uint64_t BurstyArrivalModel::nextArrival(uint64_t after)
+{
+    uint64_t burstCycle = burstCyclesThrough(after + 1) + sampleGap(1.0 / burstRate) - 1;
+    return burstCycle / onCycles * period + burstCycle % onCycles;
+}
+
+// Number of cycles in [0, cycle) that fall inside a burst; each period
+// opens with its burst
+uint64_t BurstyArrivalModel::burstCyclesThrough(uint64_t cycle) const
+{
+    return cycle / period * onCycles + std::min(cycle % period, onCycles);
+}
@@ -0,0 +1,26 @@
+#ifndef BURSTY_ARRIVAL_MODEL_H
+#define BURSTY_ARRIVAL_MODEL_H
+
+#include "IArrivalModel.h"
+
+// Alternates bursts of burst-on-cycles with idle gaps of burst-off-cycles.
+// Arrivals are Poisson within a burst, at the rate that keeps the long-run
+// average at one per batch-process-freq cycles.
+class BurstyArrivalModel : public IArrivalModel
+{
+public:
+    BurstyArrivalModel(uint32_t batchFreq, uint32_t onCycles, uint32_t offCycles);
+
+    uint64_t arrivals(uint64_t from, uint64_t to) override;
+    uint64_t nextArrival(uint64_t after) override;
+    std::string getName() const override { return "bursty"; }
+
+private:
+    uint64_t onCycles;
+    uint64_t period;
+    double burstRate; // Mean arrivals per cycle within a burst
+
+    uint64_t burstCyclesThrough(uint64_t cycle) const;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "CLI.h"
+#include "ProcessLogger.h"
 #include <iostream>
 #include <sstream>
 #include "Config.h"
@@ -49,6 +50,16 @@ void CLI::start()
                 displayHeader();
                 continue;
             }
+
+            // Stop the generator and any replay while the scheduler they
+            // feed still exists, then the scheduler, which drops its
+            // arrival hook, before the singletons are torn down
+            ProcessManager::getInstance().stopBatchProcessing();
+            ProcessManager::getInstance().stopReplay();
+            if (initialized)
+            {
+                Scheduler::getInstance().stopScheduling();
+            }
             break;
         }
 
@@ -86,15 +97,20 @@ void CLI::handleCommand(const std::string &command)
         {
             std::string flag;
             std::string processName;
-            iss >> flag >> processName;
+            iss >> flag;
 
-            if (flag == "-s" || flag == "-r" || flag == "-ls")
+            if (flag == "-ls")
             {
+                listProcesses(iss);
+            }
+            else if (flag == "-s" || flag == "-r")
+            {
+                iss >> processName;
                 handleScreenCommand(flag, processName);
             }
             else
             {
-                std::cout << "Invalid screen command. Use -s <name>, -r <name>, or -ls\n";
+                std::cout << "Invalid screen command. Use -s <name>, -r <name>, or -ls [--limit N] [--offset N]\n";
             }
         }
         else if (cmd == "scheduler-test")
@@ -119,6 +135,31 @@ void CLI::handleCommand(const std::string &command)
         {
             displayVirtualMemoryStats();
         }
+        else if (cmd == "compact")
+        {
+            compactMemory();
+        }
+        else if (cmd == "replay")
+        {
+            std::string path;
+            iss >> path;
+            if (path.empty())
+            {
+                std::cout << "Usage: replay <trace-file>\n";
+            }
+            else
+            {
+                try
+                {
+                    size_t count = ProcessManager::getInstance().replay(path);
+                    std::cout << "Replaying " << count << " admissions from " << path << ".\n";
+                }
+                catch (const std::exception &e)
+                {
+                    std::cout << "Error: " << e.what() << "\n";
+                }
+            }
+        }
         else if (cmd != "exit")
         {
             std::cout << "Invalid command.\n";
@@ -154,6 +195,8 @@ void CLI::initialize()
     {
         Config::getInstance().loadConfig("config.txt");
         MemoryManager::getInstance().initialize();
+        ProcessManager::getInstance().initialize();
+        ProcessLogger::getInstance().initialize();
         initialized = true;
         Scheduler::getInstance().startScheduling();
         std::cout << "System initialized successfully.\n";
@@ -224,10 +267,27 @@ void CLI::handleScreenCommand(const std::string &flag, const std::string &proces
             std::cout << "Process " << processName << " not found.\n";
         }
     }
-    else if (flag == "-ls")
+}
+
+// screen -ls [--limit N] [--offset N]; both count across the running and
+// finished sections together
+void CLI::listProcesses(std::istringstream &args)
+{
+    size_t limit = SIZE_MAX;
+    size_t offset = 0;
+    std::string option;
+    while (args >> option)
     {
-        ProcessManager::getInstance().listProcesses();
+        long long value;
+        if ((option != "--limit" && option != "--offset") || !(args >> value) || value < 0)
+        {
+            std::cout << "Usage: screen -ls [--limit N] [--offset N]\n";
+            return;
+        }
+        (option == "--limit" ? limit : offset) = static_cast<size_t>(value);
     }
+
+    ProcessManager::getInstance().listProcesses(offset, limit);
 }
 
 void CLI::displayProcessScreen(const std::string &processName)
@@ -313,6 +373,11 @@ void CLI::displayVirtualMemoryStats()
     uint64_t pagesIn = memManager.getPagesPagedIn();
     uint64_t pagesOut = memManager.getPagesPagedOut();
 
+    // Page replacement statistics
+    uint64_t references = memManager.getPageReferences();
+    uint64_t faults = memManager.getPageFaults();
+    double faultRate = references > 0 ? (faults * 100.0) / references : 0.0;
+
     std::cout << "\n=== Virtual Memory Statistics ===\n";
     std::cout << std::left << std::setw(20) << "Memory (KB):"
               << "total=" << totalMem << ", used=" << usedMem << ", free=" << freeMem << "\n";
@@ -320,8 +385,158 @@ void CLI::displayVirtualMemoryStats()
     std::cout << std::left << std::setw(20) << "CPU Ticks:"
               << "idle=" << idleTicks << ", active=" << activeTicks << ", total=" << totalTicks << "\n";
 
+    if (Config::getInstance().getEngine() == "event")
+    {
+        std::cout << std::left << std::setw(20) << "Event Engine:"
+                  << "events=" << scheduler.getEvents() << ", skipped=" << scheduler.getSkippedCycles() << " cycles";
+        if (Config::getInstance().getEventHorizon() > 0)
+        {
+            std::cout << ", horizon=" << Config::getInstance().getEventHorizon();
+        }
+        std::cout << "\n";
+    }
+
     std::cout << std::left << std::setw(20) << "Page Operations:"
               << "in=" << pagesIn << ", out=" << pagesOut << "\n";
+
+    // Replacement, swap, the TLBs and the frame pools only exist with paging;
+    // the flat allocator's own sections follow below
+    if (memManager.isPageBasedAllocation())
+    {
+        std::cout << std::left << std::setw(20) << "Page Replacement:"
+                  << "policy=" << memManager.getReplacementPolicyName()
+                  << ", refs=" << references << ", faults=" << faults
+                  << ", evictions=" << memManager.getPageEvictions()
+                  << ", fault-rate=" << std::fixed << std::setprecision(2) << faultRate << "%\n";
+
+        // Backing store statistics, latencies are power-of-two bucket bounds
+        SwapStats swap = memManager.getSwapStats();
+        size_t slotKB = Config::getInstance().getMemPerFrame();
+        std::cout << std::left << std::setw(20) << "Swap (KB):"
+                  << "total=" << swap.totalSlots * slotKB << ", used=" << swap.usedSlots * slotKB
+                  << ", full-failures=" << swap.fullFailures << "\n";
+        std::cout << std::left << std::setw(20) << "Swap I/O:"
+                  << "reads=" << swap.reads << " (p50<=" << swap.readP50 << "ns, p99<=" << swap.readP99 << "ns)"
+                  << ", writes=" << swap.writes << " (p50<=" << swap.writeP50 << "ns, p99<=" << swap.writeP99 << "ns)\n";
+
+        std::cout << std::left << std::setw(20) << "Fault Stalls:"
+                  << "on-dispatch=" << scheduler.getDispatchFaultStalls() << "/" << scheduler.getDispatches()
+                  << ", total-cycles=" << memManager.getFaultStalls() << "\n";
+        std::cout << std::left << std::setw(20) << "Prefetch:"
+                  << "requests=" << memManager.getPrefetchRequests()
+                  << ", hits=" << memManager.getPrefetchHits() << "\n";
+        std::cout << std::left << std::setw(20) << "Working Set:"
+                  << "demand=" << memManager.getWorkingSetDemand() << "/" << memManager.getFrameCapacity() << " frames"
+                  << ", suspended=" << Scheduler::getInstance().getSuspendedCount()
+                  << " (suspensions=" << Scheduler::getInstance().getSuspensions()
+                  << ", resumes=" << Scheduler::getInstance().getResumes() << ")"
+                  << ", throttled-batches=" << ProcessManager::getInstance().getThrottledBatches() << "\n";
+
+        std::vector<TLBStats> tlbs = memManager.getTLBStats();
+        for (size_t core = 0; core < tlbs.size(); ++core)
+        {
+            uint64_t lookups = tlbs[core].hits + tlbs[core].misses;
+            double hitRate = lookups ? (100.0 * tlbs[core].hits) / lookups : 0.0;
+            std::cout << std::left << std::setw(20) << ("TLB (core " + std::to_string(core) + "):")
+                      << "hits=" << tlbs[core].hits
+                      << ", misses=" << tlbs[core].misses
+                      << ", hit-rate=" << std::fixed << std::setprecision(2) << hitRate << "%"
+                      << ", shootdowns=" << tlbs[core].shootdowns
+                      << ", switches=" << tlbs[core].switches
+                      << ", penalty=" << tlbs[core].penaltyCycles << " cycles\n";
+        }
+
+        CompressedPoolStats pool = memManager.getCompressedPoolStats();
+        std::cout << std::left << std::setw(20) << "Compressed Pool:"
+                  << "used=" << pool.usedBytes / 1024 << "/" << pool.capacity / 1024 << "KB"
+                  << ", pages=" << pool.storedPages
+                  << ", ratio=" << std::fixed << std::setprecision(1) << pool.ratio << ":1"
+                  << ", hits=" << pool.hits
+                  << ", writebacks=" << pool.writebacks
+                  << ", rejects=" << pool.rejects << "\n";
+
+        SharingStats sharing = memManager.getSharingStats();
+        std::cout << std::left << std::setw(20) << "Sharing:"
+                  << "text-pages=" << sharing.textImages
+                  << ", shared=" << sharing.sharedFrames << " frames (" << sharing.sharedMappings << " mappings)"
+                  << ", private=" << sharing.privateFrames << " frames"
+                  << ", cow-faults=" << sharing.cowFaults
+                  << ", text-reclaims=" << sharing.textReclaims << "\n";
+        std::cout << std::left << std::setw(20) << "Frame Pools:"
+                  << "shards=" << memManager.getFramePoolShards()
+                  << ", rebalances=" << memManager.getFramePoolRebalances() << "\n";
+        HugeFrameStats huge = memManager.getHugeFrameStats();
+        if (huge.frameSize > 0)
+        {
+            std::cout << std::left << std::setw(20) << "Huge Frames:"
+                      << "size=" << huge.frameSize / 1024 << "KB, free=" << huge.freeFrames << "/" << huge.totalFrames
+                      << ", mapped=" << huge.mappings << ", carved=" << huge.carves
+                      << ", reassembled=" << huge.reassemblies
+                      << ", fallbacks=" << huge.fallbacks << "\n";
+        }
+    }
+    auto &logger = ProcessLogger::getInstance();
+    if (logger.isEnabled())
+    {
+        std::cout << std::left << std::setw(20) << "Process Log:"
+                  << "lines=" << logger.getLinesWritten()
+                  << ", dropped=" << logger.getDropped()
+                  << ", batches=" << logger.getBatchesWritten()
+                  << ", bytes=" << logger.getBytesWritten() << "\n";
+    }
+    if (logger.isIndexed())
+    {
+        LogStore::Stats stats = logger.getStoreStats();
+        std::cout << std::left << std::setw(20) << "Log Store:"
+                  << "segments=" << stats.segments
+                  << ", used=" << stats.usedBytes / 1024 << "KB"
+                  << ", live=" << stats.liveBytes / 1024 << "KB"
+                  << ", compactions=" << stats.compactions
+                  << ", reclaimed=" << stats.reclaimedBytes / 1024 << "KB\n";
+    }
+
+    if (Config::getInstance().getSnapshotInterval() > 0)
+    {
+        std::cout << std::left << std::setw(20) << "Snapshots:"
+                  << "written=" << memManager.getSnapshotsWritten()
+                  << ", dropped=" << memManager.getSnapshotsDropped()
+                  << ", file=" << Config::getInstance().getSnapshotFile() << "\n";
+    }
+
+    if (!memManager.isPageBasedAllocation())
+    {
+        FlatStats flat = memManager.getFlatStats();
+        size_t usedBytes = memManager.getUsedMemory();
+        double internalPct = usedBytes > 0 ? (flat.internalFragmentation * 100.0) / usedBytes : 0.0;
+        std::cout << std::left << std::setw(20) << "Flat Allocator:"
+                  << "policy=" << flat.allocator << ", live=" << flat.liveBlocks
+                  << ", free-blocks=" << flat.freeBlocks
+                  << ", largest-free=" << flat.largestFreeBlock / 1024 << "KB"
+                  << ", swap-outs=" << flat.swapOuts << "\n";
+        std::cout << std::left << std::setw(20) << "Fragmentation:"
+                  << "internal=" << flat.internalFragmentation / 1024 << "KB ("
+                  << std::fixed << std::setprecision(2) << internalPct << "%)"
+                  << ", external=" << flat.externalFragmentation << "%\n";
+        std::cout << std::left << std::setw(20) << "Compaction:"
+                  << "runs=" << flat.compactions << " (auto=" << flat.autoCompactions << ")"
+                  << ", moved=" << flat.compactedBytes / 1024 << "KB\n";
+    }
+}
+
+void CLI::compactMemory()
+{
+    auto &memManager = MemoryManager::getInstance();
+
+    size_t bytesMoved = 0;
+    if (!memManager.compactMemory(bytesMoved))
+    {
+        std::cout << "Compaction requires flat memory with the segregated allocator.\n";
+        return;
+    }
+
+    FlatStats flat = memManager.getFlatStats();
+    std::cout << "Compaction moved " << bytesMoved / 1024 << "KB; largest free block is now "
+              << flat.largestFreeBlock / 1024 << "KB\n";
 }
 
 void CLI::clearScreen()
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <memory>
+#include <sstream>
 #include <windows.h>
 #include "ProcessManager.h"
 
@@ -29,10 +30,12 @@ private:
     void displayProcessScreen(const std::string &processName);
     void handleCommand(const std::string &command);
     void handleScreenCommand(const std::string &flag, const std::string &processName);
+    void listProcesses(std::istringstream &args);
     void initialize();
 
     void displayProcessMemoryInfo();
     void displayVirtualMemoryStats();
+    void compactMemory();
 };
 
 #endif
\ No newline at end of file
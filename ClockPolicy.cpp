@@ -0,0 +1,37 @@
+#include "ClockPolicy.h"
+#include "FrameTable.h"
+
+ClockPolicy::ClockPolicy(size_t /*numFrames*/)
+    : IReplacementPolicy(CLOCK), hand(0)
+{
+}
+
+bool ClockPolicy::selectVictim(FrameTable &frameTable, uint32_t &victim)
+{
+    if (frameTable.empty())
+    {
+        return false;
+    }
+
+    // The first sweep clears referenced bits, so the second one must stop
+    for (size_t step = 0; step < 2 * frameTable.size(); ++step)
+    {
+        uint32_t frame = static_cast<uint32_t>(hand);
+        hand = (hand + 1) % frameTable.size();
+
+        if (!frameTable.isEvictable(frame))
+        {
+            continue;
+        }
+
+        if (frameTable.testAndClear(frame, FrameTable::REFERENCED))
+        {
+            continue;
+        }
+
+        victim = frame;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,21 @@
+#ifndef CLOCK_POLICY_H
+#define CLOCK_POLICY_H
+
+#include "IReplacementPolicy.h"
+
+// Single-hand clock sweeping the frame table in frame order
+class ClockPolicy : public IReplacementPolicy
+{
+public:
+    ClockPolicy(size_t numFrames);
+
+    void onFrameLoaded(uint32_t /*frame*/) override {}
+    void onFrameFreed(uint32_t /*frame*/) override {}
+    bool selectVictim(FrameTable &frameTable, uint32_t &victim) override;
+    std::string getName() const override { return "clock"; }
+
+private:
+    size_t hand;
+};
+
+#endif
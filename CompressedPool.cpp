@@ -0,0 +1,164 @@
+#include "CompressedPool.h"
+#include <cstring>
+#include <iterator>
+
+void CompressedPool::initialize(size_t pageSize, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    this->pageSize = pageSize;
+    this->capacity = capacity;
+    entries.clear();
+    ageOrder.clear();
+    usedBytes = 0;
+    stores = 0;
+    rejects = 0;
+    hits = 0;
+    writebacks = 0;
+}
+
+bool CompressedPool::store(uint64_t key, const char *page)
+{
+    if (!isEnabled())
+        return false;
+
+    std::vector<char> data;
+    if (!compress(page, pageSize, pageSize / 2, data) || data.size() > capacity)
+    {
+        rejects.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    auto it = entries.find(key);
+    if (it != entries.end())
+    {
+        removeEntry(it);
+    }
+
+    ageOrder.push_back(key);
+    Entry &entry = entries[key];
+    entry.age = std::prev(ageOrder.end());
+    usedBytes.fetch_add(data.size(), std::memory_order_relaxed);
+    entry.data.swap(data);
+    stores.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool CompressedPool::load(uint64_t key, char *page)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return false;
+
+    decompress(it->second.data, page, pageSize);
+    removeEntry(it);
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CompressedPool::erase(uint64_t key)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    auto it = entries.find(key);
+    if (it != entries.end())
+    {
+        removeEntry(it);
+    }
+}
+
+bool CompressedPool::evictOldest(uint64_t &key, char *page)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    if (usedBytes.load(std::memory_order_relaxed) <= capacity || ageOrder.empty())
+        return false;
+
+    key = ageOrder.front();
+    auto it = entries.find(key);
+    decompress(it->second.data, page, pageSize);
+    removeEntry(it);
+    writebacks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t CompressedPool::getStoredPages() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return entries.size();
+}
+
+void CompressedPool::removeEntry(std::unordered_map<uint64_t, Entry>::iterator it)
+{
+    usedBytes.fetch_sub(it->second.data.size(), std::memory_order_relaxed);
+    ageOrder.erase(it->second.age);
+    entries.erase(it);
+}
+
+// Each block starts with a header byte n: 0..127 copies the next n + 1 bytes
+// literally, 129..255 repeats the next byte 257 - n times (128 is unused).
+// Gives up once the output would exceed limit.
+bool CompressedPool::compress(const char *input, size_t size, size_t limit, std::vector<char> &output)
+{
+    output.clear();
+    size_t pos = 0;
+    while (pos < size)
+    {
+        size_t run = 1;
+        while (pos + run < size && run < 128 && input[pos + run] == input[pos])
+        {
+            ++run;
+        }
+
+        if (run >= 2)
+        {
+            output.push_back(static_cast<char>(257 - run));
+            output.push_back(input[pos]);
+            pos += run;
+        }
+        else
+        {
+            // Literal block up to the next run of at least three bytes
+            size_t start = pos;
+            while (pos < size && pos - start < 128)
+            {
+                if (pos + 2 < size && input[pos] == input[pos + 1] && input[pos] == input[pos + 2])
+                    break;
+                ++pos;
+            }
+            output.push_back(static_cast<char>(pos - start - 1));
+            output.insert(output.end(), input + start, input + pos);
+        }
+
+        if (output.size() > limit)
+            return false;
+    }
+    return true;
+}
+
+void CompressedPool::decompress(const std::vector<char> &input, char *output, size_t size)
+{
+    size_t in = 0;
+    size_t out = 0;
+    while (in < input.size() && out < size)
+    {
+        unsigned char header = static_cast<unsigned char>(input[in++]);
+        if (header < 128)
+        {
+            size_t count = header + 1;
+            std::memcpy(output + out, &input[in], count);
+            in += count;
+            out += count;
+        }
+        else if (header > 128)
+        {
+            size_t count = 257 - header;
+            std::memset(output + out, input[in++], count);
+            out += count;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef COMPRESSED_POOL_H
+#define COMPRESSED_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Bounded in-RAM cache of compressed pages that sits in front of the swap
+// store. Evicted pages land here first; the oldest entries are written
+// back to swap once the pool grows past its capacity.
+class CompressedPool
+{
+public:
+    CompressedPool() : pageSize(0), capacity(0), usedBytes(0), stores(0), rejects(0), hits(0), writebacks(0) {}
+
+    CompressedPool(const CompressedPool &) = delete;
+    CompressedPool &operator=(const CompressedPool &) = delete;
+
+    void initialize(size_t pageSize, size_t capacity);
+    bool isEnabled() const { return capacity > 0; }
+
+    // Compresses and stores a page. Fails for pages that do not compress
+    // to under half their size, which go straight to swap instead.
+    bool store(uint64_t key, const char *page);
+
+    // Decompresses a page into the buffer and drops it from the pool
+    bool load(uint64_t key, char *page);
+    void erase(uint64_t key);
+
+    // Removes the oldest page while the pool is over capacity, for writeback
+    bool evictOldest(uint64_t &key, char *page);
+
+    // Statistics for vmstat
+    size_t getCapacity() const { return capacity; }
+    size_t getStoredPages() const;
+    size_t getUsedBytes() const { return usedBytes.load(std::memory_order_relaxed); }
+    uint64_t getStores() const { return stores.load(std::memory_order_relaxed); }
+    uint64_t getRejects() const { return rejects.load(std::memory_order_relaxed); }
+    uint64_t getHits() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t getWritebacks() const { return writebacks.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry
+    {
+        std::vector<char> data;
+        std::list<uint64_t>::iterator age;
+    };
+
+    size_t pageSize;
+    size_t capacity; // Bytes of compressed data, 0 disables the pool
+
+    mutable std::mutex poolMutex;
+    std::unordered_map<uint64_t, Entry> entries;
+    std::list<uint64_t> ageOrder; // Oldest first
+
+    std::atomic<size_t> usedBytes;
+    std::atomic<uint64_t> stores;
+    std::atomic<uint64_t> rejects;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> writebacks;
+
+    void removeEntry(std::unordered_map<uint64_t, Entry>::iterator it);
+
+    // PackBits run-length codec
+    static bool compress(const char *input, size_t size, size_t limit, std::vector<char> &output);
+    static void decompress(const std::vector<char> &input, char *output, size_t size);
+};
+
+#endif
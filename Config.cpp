@@ -1,7 +1,29 @@
 #include "Config.h"
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 
+// The swap file is scratch space sized to a multiple of memory, so keep it
+// out of the working directory unless swap-file says otherwise
+std::string Config::defaultSwapFile()
+{
+#ifdef _WIN32
+    const char *dir = std::getenv("TEMP");
+    const char *fallback = ".";
+    const char separator = '\\';
+#else
+    const char *dir = std::getenv("TMPDIR");
+    const char *fallback = "/tmp";
+    const char separator = '/';
+#endif
+    std::string path = (dir != nullptr && *dir != '\0') ? dir : fallback;
+    if (path.back() != separator)
+    {
+        path += separator;
+    }
+    return path + "csopesy-swap.bin";
+}
+
 void Config::loadConfig(const std::string &filename)
 {
     std::ifstream file(filename);
@@ -81,6 +103,107 @@ void Config::loadConfig(const std::string &filename)
             file >> maxMemPerProc;
             requiredParams[param] = true;
         }
+        else if (param == "page-replacement")
+        {
+            file >> pageReplacement;
+        }
+        else if (param == "swap-file")
+        {
+            file >> swapFile;
+        }
+        else if (param == "swap-size")
+        {
+            file >> swapSize;
+        }
+        else if (param == "prefetch-depth")
+        {
+            file >> prefetchDepth;
+        }
+        else if (param == "flat-allocator")
+        {
+            file >> flatAllocator;
+        }
+        else if (param == "compaction-threshold")
+        {
+            file >> compactionThreshold;
+        }
+        else if (param == "compressed-pool")
+        {
+            file >> compressedPool;
+        }
+        else if (param == "tlb-miss-penalty")
+        {
+            file >> tlbMissPenalty;
+        }
+        else if (param == "working-set-window")
+        {
+            file >> workingSetWindow;
+        }
+        else if (param == "huge-frame-factor")
+        {
+            file >> hugeFrameFactor;
+        }
+        else if (param == "huge-frame-threshold")
+        {
+            file >> hugeFrameThreshold;
+        }
+        else if (param == "huge-frame-region")
+        {
+            file >> hugeFrameRegion;
+        }
+        else if (param == "snapshot-interval")
+        {
+            file >> snapshotInterval;
+        }
+        else if (param == "snapshot-file")
+        {
+            file >> snapshotFile;
+        }
+        else if (param == "arrival-model")
+        {
+            file >> arrivalModel;
+        }
+        else if (param == "burst-on-cycles")
+        {
+            file >> burstOnCycles;
+        }
+        else if (param == "burst-off-cycles")
+        {
+            file >> burstOffCycles;
+        }
+        else if (param == "trace-file")
+        {
+            file >> traceFile;
+        }
+        else if (param == "log-output")
+        {
+            file >> logOutput;
+        }
+        else if (param == "log-file")
+        {
+            file >> logFile;
+        }
+        else if (param == "log-segment-size")
+        {
+            file >> logSegmentSize;
+        }
+        else if (param == "log-tail-lines")
+        {
+            file >> logTailLines;
+        }
+        else if (param == "seed")
+        {
+            file >> seed;
+            deterministic = true;
+        }
+        else if (param == "engine")
+        {
+            file >> engine;
+        }
+        else if (param == "event-horizon")
+        {
+            file >> eventHorizon;
+        }
         else
         {
             throw ConfigException("Unknown parameter: " + param);
@@ -169,4 +292,95 @@ void Config::validateParameters()
     {
         throw ConfigException("max-mem-per-proc cannot exceed max-overall-mem");
     }
+
+    if (pageReplacement != "fifo" && pageReplacement != "clock" &&
+        pageReplacement != "second-chance" && pageReplacement != "lru")
+    {
+        throw ConfigException("Invalid page-replacement (must be 'fifo', 'clock', 'second-chance' or 'lru'): " +
+                              pageReplacement);
+    }
+
+    if (flatAllocator != "firstfit" && flatAllocator != "buddy" && flatAllocator != "segregated")
+    {
+        throw ConfigException("Invalid flat-allocator (must be 'firstfit', 'buddy' or 'segregated'): " +
+                              flatAllocator);
+    }
+
+    if (compactionThreshold > 100)
+    {
+        throw ConfigException("Invalid compaction-threshold (must be between 0 and 100): " +
+                              std::to_string(compactionThreshold));
+    }
+
+    if (compressedPool > 100)
+    {
+        throw ConfigException("Invalid compressed-pool (must be between 0 and 100): " +
+                              std::to_string(compressedPool));
+    }
+
+    if (hugeFrameFactor < 1 || hugeFrameFactor > 512 || !isPowerOfTwo(hugeFrameFactor))
+    {
+        throw ConfigException("Invalid huge-frame-factor (must be a power of 2 between 1 and 512): " +
+                              std::to_string(hugeFrameFactor));
+    }
+
+    if (hugeFrameRegion > 100)
+    {
+        throw ConfigException("Invalid huge-frame-region (must be between 0 and 100): " +
+                              std::to_string(hugeFrameRegion));
+    }
+
+    if (arrivalModel != "fixed" && arrivalModel != "poisson" && arrivalModel != "bursty")
+    {
+        throw ConfigException("Invalid arrival-model (must be 'fixed', 'poisson' or 'bursty'): " + arrivalModel);
+    }
+
+    if (logOutput != "off" && logOutput != "shared" && logOutput != "per-process" && logOutput != "indexed")
+    {
+        throw ConfigException("Invalid log-output (must be 'off', 'shared', 'per-process' or 'indexed'): " + logOutput);
+    }
+
+    if (engine != "threaded" && engine != "event")
+    {
+        throw ConfigException("Invalid engine (must be 'threaded' or 'event'): " + engine);
+    }
+
+    // Record offsets within a segment are 32-bit
+    if (logSegmentSize < 64 || logSegmentSize > 1048576)
+    {
+        throw ConfigException("Invalid log-segment-size (must be between 64 and 1048576 KB): " +
+                              std::to_string(logSegmentSize));
+    }
+
+    if (logTailLines > 1000)
+    {
+        throw ConfigException("Invalid log-tail-lines (must be between 0 and 1000): " + std::to_string(logTailLines));
+    }
+
+    if (burstOnCycles < 1 || burstOffCycles < 1)
+    {
+        throw ConfigException("Invalid burst-on-cycles/burst-off-cycles (must be at least 1): " +
+                              std::to_string(burstOnCycles) + "/" + std::to_string(burstOffCycles));
+    }
+
+    if (hugeFrameThreshold == 0)
+    {
+        hugeFrameThreshold = hugeFrameFactor * memPerFrame;
+    }
+
+    if (swapSize == 0)
+    {
+        uint64_t defaultSwapSize = static_cast<uint64_t>(maxOverallMem) * 4;
+        if (defaultSwapSize > UINT32_MAX)
+        {
+            throw ConfigException("max-overall-mem too large for the default swap-size (set swap-size explicitly): " +
+                                  std::to_string(maxOverallMem));
+        }
+        swapSize = static_cast<uint32_t>(defaultSwapSize);
+    }
+
+    if (swapSize < memPerFrame)
+    {
+        throw ConfigException("Invalid swap-size (must be at least mem-per-frame): " + std::to_string(swapSize));
+    }
 }
\ No newline at end of file
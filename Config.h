@@ -33,6 +33,38 @@ public:
     uint32_t getMinMemPerProc() const { return minMemPerProc; }
     uint32_t getMaxMemPerProc() const { return maxMemPerProc; }
 
+    // Optional parameters
+    std::string getPageReplacement() const { return pageReplacement; }
+    std::string getSwapFile() const { return swapFile; }
+    uint32_t getSwapSize() const { return swapSize; }
+    uint32_t getPrefetchDepth() const { return prefetchDepth; }
+    std::string getFlatAllocator() const { return flatAllocator; }
+    uint32_t getCompactionThreshold() const { return compactionThreshold; }
+    uint32_t getCompressedPool() const { return compressedPool; }
+    uint32_t getTLBMissPenalty() const { return tlbMissPenalty; }
+    uint32_t getWorkingSetWindow() const { return workingSetWindow; }
+    uint32_t getHugeFrameFactor() const { return hugeFrameFactor; }
+    uint32_t getHugeFrameThreshold() const { return hugeFrameThreshold; }
+    uint32_t getHugeFrameRegion() const { return hugeFrameRegion; }
+    uint32_t getSnapshotInterval() const { return snapshotInterval; }
+    std::string getSnapshotFile() const { return snapshotFile; }
+    std::string getArrivalModel() const { return arrivalModel; }
+    uint32_t getBurstOnCycles() const { return burstOnCycles; }
+    uint32_t getBurstOffCycles() const { return burstOffCycles; }
+    std::string getTraceFile() const { return traceFile; }
+    std::string getLogOutput() const { return logOutput; }
+    std::string getLogFile() const { return logFile; }
+    uint32_t getLogSegmentSize() const { return logSegmentSize; }
+    uint32_t getLogTailLines() const { return logTailLines; }
+    bool isDeterministic() const { return deterministic; }
+    uint64_t getSeed() const { return seed; }
+    std::string getEngine() const { return engine; }
+    uint64_t getEventHorizon() const { return eventHorizon; }
+
+    // Deterministic mode and the event engine run every core on one
+    // scheduler thread, which also services page-ins, snapshots and arrivals
+    bool isSingleThreaded() const { return deterministic || engine == "event"; }
+
     // Exception class for Config
     class ConfigException : public std::runtime_error
     {
@@ -41,7 +73,14 @@ public:
     };
 
 private:
-    Config() : initialized(false) {}
+    Config() : pageReplacement("fifo"), swapFile(defaultSwapFile()), swapSize(0), prefetchDepth(2), flatAllocator("firstfit"),
+               compactionThreshold(50), compressedPool(20), tlbMissPenalty(0),
+               workingSetWindow(50), hugeFrameFactor(1), hugeFrameThreshold(0), hugeFrameRegion(25),
+               snapshotInterval(0), snapshotFile("csopesy-memory.snap"), arrivalModel("fixed"),
+               burstOnCycles(100), burstOffCycles(100), logOutput("shared"), logFile("csopesy-process.log"),
+               logSegmentSize(4096), logTailLines(10), deterministic(false), seed(0),
+               engine("threaded"), eventHorizon(0),
+               initialized(false) {}
 
     int numCPU;                // Range: [1, 128]
     std::string schedulerType; // fcfs or rr
@@ -56,10 +95,39 @@ private:
     uint32_t minMemPerProc; // Min memory per process in KB
     uint32_t maxMemPerProc; // Max memory per process in KB
 
+    std::string pageReplacement; // fifo, clock, second-chance or lru
+    std::string swapFile;        // Backing store path, in the temp directory by default
+    uint32_t swapSize;           // Backing store size in KB, 0 for 4x max-overall-mem
+    uint32_t prefetchDepth;      // Ready queue entries prefetched on dispatch, 0 disables
+    std::string flatAllocator;   // firstfit, buddy or segregated
+    uint32_t compactionThreshold; // External fragmentation percent for auto compaction, 0 disables
+    uint32_t compressedPool;      // Compressed page pool as a percent of max-overall-mem, 0 disables
+    uint32_t tlbMissPenalty;      // Cycles a core spends walking the page table after a TLB miss
+    uint32_t workingSetWindow;    // Cycles per working set sample and load control step, 0 disables
+    uint32_t hugeFrameFactor;     // Base frames per huge frame, 1 disables huge frames
+    uint32_t hugeFrameThreshold;  // Process memory in KB at which huge frames are used, 0 for one huge frame
+    uint32_t hugeFrameRegion;     // Percent of frames set aside as huge frames
+    uint32_t snapshotInterval;    // Quanta between memory-map snapshots, 0 disables
+    std::string snapshotFile;     // Snapshot output path
+    std::string arrivalModel;     // fixed, poisson or bursty batch process arrivals
+    uint32_t burstOnCycles;       // Bursty model: cycles per arrival burst
+    uint32_t burstOffCycles;      // Bursty model: idle cycles between bursts
+    std::string traceFile;        // Workload trace output path, empty disables
+    std::string logOutput;        // Process output: off, shared, per-process (<name>.txt) or indexed
+    std::string logFile;          // Shared process output path; indexed segments add .000001 and up
+    uint32_t logSegmentSize;      // Indexed log segment size in KB
+    uint32_t logTailLines;        // Recent output lines shown by screen -r and process-smi, 0 disables
+    bool deterministic;           // Set by the seed key: seeded RNGs and lock-step cores
+    uint64_t seed;                // Root of every generator in deterministic mode
+    std::string engine;           // threaded (a thread per core) or event (discrete-event, skips idle cycles)
+    uint64_t eventHorizon;        // Event engine: cycle at which the clock stops, 0 for none
+
     bool initialized;
 
     void validateParameters();
 
+    static std::string defaultSwapFile();
+
     static bool isPowerOfTwo(uint32_t x)
     {
         return x && !(x & (x - 1));
@@ -0,0 +1,88 @@
+#include "FIFOPolicy.h"
+#include "FrameTable.h"
+
+const uint32_t FIFOPolicy::NIL;
+
+FIFOPolicy::FIFOPolicy(size_t numFrames)
+    : FIFOPolicy(numFrames, FIFO)
+{
+}
+
+FIFOPolicy::FIFOPolicy(size_t numFrames, PolicyType policyType)
+    : IReplacementPolicy(policyType),
+      prev(numFrames, NIL),
+      next(numFrames, NIL),
+      queued(numFrames, false),
+      head(NIL),
+      tail(NIL)
+{
+}
+
+void FIFOPolicy::onFrameLoaded(uint32_t frame)
+{
+    if (queued[frame])
+    {
+        unlink(frame);
+    }
+    pushBack(frame);
+}
+
+void FIFOPolicy::onFrameFreed(uint32_t frame)
+{
+    if (queued[frame])
+    {
+        unlink(frame);
+    }
+}
+
+bool FIFOPolicy::selectVictim(FrameTable & /*frameTable*/, uint32_t &victim)
+{
+    if (head == NIL)
+    {
+        return false;
+    }
+
+    victim = head;
+    return true;
+}
+
+void FIFOPolicy::pushBack(uint32_t frame)
+{
+    prev[frame] = tail;
+    next[frame] = NIL;
+    if (tail != NIL)
+    {
+        next[tail] = frame;
+    }
+    else
+    {
+        head = frame;
+    }
+    tail = frame;
+    queued[frame] = true;
+}
+
+void FIFOPolicy::unlink(uint32_t frame)
+{
+    if (prev[frame] != NIL)
+    {
+        next[prev[frame]] = next[frame];
+    }
+    else
+    {
+        head = next[frame];
+    }
+
+    if (next[frame] != NIL)
+    {
+        prev[next[frame]] = prev[frame];
+    }
+    else
+    {
+        tail = prev[frame];
+    }
+
+    prev[frame] = NIL;
+    next[frame] = NIL;
+    queued[frame] = false;
+}
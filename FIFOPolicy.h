@@ -0,0 +1,31 @@
+#ifndef FIFO_POLICY_H
+#define FIFO_POLICY_H
+
+#include "IReplacementPolicy.h"
+
+class FIFOPolicy : public IReplacementPolicy
+{
+public:
+    FIFOPolicy(size_t numFrames);
+
+    void onFrameLoaded(uint32_t frame) override;
+    void onFrameFreed(uint32_t frame) override;
+    bool selectVictim(FrameTable &frameTable, uint32_t &victim) override;
+    std::string getName() const override { return "fifo"; }
+
+protected:
+    FIFOPolicy(size_t numFrames, PolicyType policyType);
+
+    // Intrusive doubly linked load-order queue over frame numbers
+    static const uint32_t NIL = UINT32_MAX;
+    std::vector<uint32_t> prev;
+    std::vector<uint32_t> next;
+    std::vector<bool> queued;
+    uint32_t head;
+    uint32_t tail;
+
+    void pushBack(uint32_t frame);
+    void unlink(uint32_t frame);
+};
+
+#endif
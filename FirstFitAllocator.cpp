@@ -0,0 +1,85 @@
+#include "FirstFitAllocator.h"
+#include <algorithm>
+
+FirstFitAllocator::FirstFitAllocator(size_t totalSize)
+    : IFlatAllocator(FIRST_FIT, totalSize)
+{
+    memoryBlocks.push_back({0, totalSize, true});
+}
+
+bool FirstFitAllocator::allocate(size_t size, size_t &address, size_t &blockSize)
+{
+    for (auto it = memoryBlocks.begin(); it != memoryBlocks.end(); ++it)
+    {
+        if (it->isFree && it->size >= size)
+        {
+            // Split block if necessary, keeping the list in address order
+            if (it->size > size)
+            {
+                MemoryBlock remainder{it->startAddress + size, it->size - size, true};
+                it->size = size;
+                it = memoryBlocks.insert(it + 1, remainder) - 1;
+            }
+
+            it->isFree = false;
+            address = it->startAddress;
+            blockSize = it->size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FirstFitAllocator::release(size_t address)
+{
+    auto it = std::lower_bound(memoryBlocks.begin(), memoryBlocks.end(), address,
+                               [](const MemoryBlock &block, size_t value)
+                               { return block.startAddress < value; });
+    if (it == memoryBlocks.end() || it->startAddress != address || it->isFree)
+        return;
+
+    it->isFree = true;
+
+    // Only the neighbours can merge with the released block
+    auto next = it + 1;
+    if (next != memoryBlocks.end() && next->isFree)
+    {
+        it->size += next->size;
+        memoryBlocks.erase(next);
+    }
+    if (it != memoryBlocks.begin() && (it - 1)->isFree)
+    {
+        (it - 1)->size += it->size;
+        memoryBlocks.erase(it);
+    }
+}
+
+size_t FirstFitAllocator::getFreeBlockCount() const
+{
+    return std::count_if(memoryBlocks.begin(), memoryBlocks.end(),
+                         [](const MemoryBlock &block)
+                         { return block.isFree; });
+}
+
+void FirstFitAllocator::getBlocks(std::vector<FlatBlock> &blocks) const
+{
+    blocks.clear();
+    for (const auto &block : memoryBlocks)
+    {
+        blocks.push_back({block.startAddress, block.size, block.isFree});
+    }
+}
+
+size_t FirstFitAllocator::getLargestFreeBlock() const
+{
+    size_t largest = 0;
+    for (const auto &block : memoryBlocks)
+    {
+        if (block.isFree)
+        {
+            largest = std::max(largest, block.size);
+        }
+    }
+    return largest;
+}
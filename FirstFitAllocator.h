@@ -0,0 +1,32 @@
+#ifndef FIRST_FIT_ALLOCATOR_H
+#define FIRST_FIT_ALLOCATOR_H
+
+#include "IFlatAllocator.h"
+#include <vector>
+
+struct MemoryBlock
+{
+    size_t startAddress;
+    size_t size;
+    bool isFree;
+};
+
+// First fit over an address-ordered block list
+class FirstFitAllocator : public IFlatAllocator
+{
+public:
+    FirstFitAllocator(size_t totalSize);
+
+    bool allocate(size_t size, size_t &address, size_t &blockSize) override;
+    void release(size_t address) override;
+    std::string getName() const override { return "firstfit"; }
+
+    size_t getFreeBlockCount() const override;
+    size_t getLargestFreeBlock() const override;
+    void getBlocks(std::vector<FlatBlock> &blocks) const override;
+
+private:
+    std::vector<MemoryBlock> memoryBlocks;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef FIXED_ARRIVAL_MODEL_H
+#define FIXED_ARRIVAL_MODEL_H
+
+#include "IArrivalModel.h"
+
+// One arrival on every cycle that is a multiple of batch-process-freq
+class FixedArrivalModel : public IArrivalModel
+{
+public:
+    FixedArrivalModel(uint32_t batchFreq) : batchFreq(batchFreq) {}
+
+    uint64_t arrivals(uint64_t from, uint64_t to) override { return to / batchFreq - from / batchFreq; }
+    uint64_t nextArrival(uint64_t after) override { return (after / batchFreq + 1) * batchFreq; }
+    std::string getName() const override { return "fixed"; }
+
+private:
+    uint64_t batchFreq;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "FramePool.h"
+#include <algorithm>
+
+void FramePool::initialize(size_t numFrames, size_t numShards)
+{
+    numShards = std::max<size_t>(1, std::min(numShards, std::max<size_t>(1, numFrames)));
+    framesPerShard = std::max<size_t>(1, (numFrames + numShards - 1) / numShards);
+
+    shards.clear();
+    for (size_t i = 0; i < numShards; ++i)
+    {
+        shards.push_back(std::unique_ptr<Shard>(new Shard));
+    }
+
+    // Each shard owns a contiguous frame range; low frames are handed out first
+    for (size_t frame = numFrames; frame > 0; --frame)
+    {
+        uint32_t frameNumber = static_cast<uint32_t>(frame - 1);
+        shards[homeShard(frameNumber)]->frames.push_back(frameNumber);
+    }
+
+    freeCount = numFrames;
+    rebalances = 0;
+}
+
+bool FramePool::take(size_t shard, size_t count, std::vector<uint32_t> &frames)
+{
+    frames.clear();
+    if (shards.empty())
+        return count == 0;
+
+    Shard &local = *shards[shard % shards.size()];
+    {
+        std::lock_guard<std::mutex> lock(local.mutex);
+        popFrames(local, count, frames);
+    }
+
+    // Local shard ran dry: take the shortfall from the next shards in turn,
+    // along with half of their remaining frames to refill this shard
+    for (size_t i = 1; i < shards.size() && frames.size() < count; ++i)
+    {
+        Shard &donor = *shards[(shard + i) % shards.size()];
+        std::vector<uint32_t> stolen;
+        {
+            std::lock_guard<std::mutex> lock(donor.mutex);
+            size_t needed = count - frames.size();
+            size_t surplus = donor.frames.size() > needed ? (donor.frames.size() - needed) / 2 : 0;
+            popFrames(donor, needed + surplus, stolen);
+        }
+
+        if (stolen.empty())
+            continue;
+
+        rebalances.fetch_add(1, std::memory_order_relaxed);
+        size_t needed = std::min(count - frames.size(), stolen.size());
+        frames.insert(frames.end(), stolen.begin(), stolen.begin() + needed);
+
+        if (needed < stolen.size())
+        {
+            std::lock_guard<std::mutex> lock(local.mutex);
+            local.frames.insert(local.frames.end(), stolen.rbegin(), stolen.rend() - needed);
+            freeCount.fetch_add(stolen.size() - needed, std::memory_order_relaxed);
+        }
+    }
+
+    return frames.size() == count;
+}
+
+void FramePool::release(uint32_t frame)
+{
+    Shard &home = *shards[homeShard(frame)];
+    std::lock_guard<std::mutex> lock(home.mutex);
+    home.frames.push_back(frame);
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool FramePool::reclaim(uint32_t first, size_t count)
+{
+    // Frames migrate between shards when stolen, so search them all. Shards
+    // are locked in index order; take() and release() hold one at a time.
+    std::vector<std::unique_lock<std::mutex>> locks;
+    size_t found = 0;
+    for (auto &shard : shards)
+    {
+        locks.push_back(std::unique_lock<std::mutex>(shard->mutex));
+        found += std::count_if(shard->frames.begin(), shard->frames.end(), [=](uint32_t frame)
+                               { return frame >= first && frame - first < count; });
+    }
+
+    if (found != count)
+        return false;
+
+    for (auto &shard : shards)
+    {
+        shard->frames.erase(std::remove_if(shard->frames.begin(), shard->frames.end(), [=](uint32_t frame)
+                                           { return frame >= first && frame - first < count; }),
+                            shard->frames.end());
+    }
+    freeCount.fetch_sub(count, std::memory_order_relaxed);
+    return true;
+}
+
+size_t FramePool::homeShard(uint32_t frame) const
+{
+    return std::min(frame / framesPerShard, shards.size() - 1);
+}
+
+void FramePool::popFrames(Shard &shard, size_t count, std::vector<uint32_t> &frames)
+{
+    count = std::min(count, shard.frames.size());
+    frames.insert(frames.end(), shard.frames.rbegin(), shard.frames.rbegin() + count);
+    shard.frames.resize(shard.frames.size() - count);
+    freeCount.fetch_sub(count, std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Free frames split into per-shard stacks so concurrent allocations on
+// different shards do not contend. A shard that runs dry steals from its
+// neighbours; released frames return to the shard that owns their range.
+class FramePool
+{
+public:
+    FramePool() : framesPerShard(1), freeCount(0), rebalances(0) {}
+
+    void initialize(size_t numFrames, size_t numShards);
+
+    // Takes up to count frames, preferring the given shard. Returns false
+    // when fewer than count were available; the taken frames are kept.
+    bool take(size_t shard, size_t count, std::vector<uint32_t> &frames);
+    void release(uint32_t frame);
+
+    // Takes the frames [first, first + count) back out of the pool, but only
+    // if every one of them is free; all shards are locked while checking
+    bool reclaim(uint32_t first, size_t count);
+
+    size_t getShardCount() const { return shards.size(); }
+    size_t getFreeFrames() const { return freeCount.load(std::memory_order_relaxed); }
+    uint64_t getRebalances() const { return rebalances.load(std::memory_order_relaxed); }
+
+private:
+    struct Shard
+    {
+        std::mutex mutex;
+        std::vector<uint32_t> frames; // LIFO, low frames on top
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t framesPerShard;
+    std::atomic<size_t> freeCount;
+    std::atomic<uint64_t> rebalances;
+
+    size_t homeShard(uint32_t frame) const;
+    void popFrames(Shard &shard, size_t count, std::vector<uint32_t> &frames);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef FRAME_TABLE_H
+#define FRAME_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Struct-of-arrays frame table indexed by frame number. Owners are stored
+// as PIDs and resolved through the MemoryManager's process table; shared
+// frames store their program image ID instead. Entries
+// are relaxed atomics so cores and the I/O thread can update reference
+// bits without sharing a lock.
+class FrameTable
+{
+public:
+    enum FrameFlag : uint8_t
+    {
+        PRESENT = 1 << 0,    // Frame is allocated
+        IN_TRANSIT = 1 << 1, // Reserved by the I/O thread while its transfer runs
+        REFERENCED = 1 << 2, // Set on every access, cleared by the replacement policy
+        DIRTY = 1 << 3,      // Set on write access
+        PREFETCHED = 1 << 4, // Brought in by prefetch and not yet referenced
+        SHARED = 1 << 5,        // Mapped read-only by every process in refCounts; never evicted
+        IN_WORKING_SET = 1 << 6, // Referenced since the last working set sample
+        HUGE = 1 << 7            // Part of a pinned huge frame; never evicted
+    };
+
+    static const uint32_t NO_OWNER = UINT32_MAX;
+
+    FrameTable() : numFrames(0) {}
+
+    void resize(size_t frames)
+    {
+        numFrames = frames;
+        flags.reset(new std::atomic<uint8_t>[frames]);
+        ownerPIDs.reset(new std::atomic<uint32_t>[frames]);
+        pageNumbers.reset(new std::atomic<uint32_t>[frames]);
+        lastAccess.reset(new std::atomic<uint64_t>[frames]);
+        refCounts.reset(new std::atomic<uint32_t>[frames]);
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            flags[frame].store(0, std::memory_order_relaxed);
+            ownerPIDs[frame].store(NO_OWNER, std::memory_order_relaxed);
+            pageNumbers[frame].store(0, std::memory_order_relaxed);
+            lastAccess[frame].store(0, std::memory_order_relaxed);
+            refCounts[frame].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    size_t size() const { return numFrames; }
+    bool empty() const { return numFrames == 0; }
+
+    bool test(uint32_t frame, FrameFlag flag) const { return (flags[frame].load(std::memory_order_relaxed) & flag) != 0; }
+    void set(uint32_t frame, FrameFlag flag) { flags[frame].fetch_or(flag, std::memory_order_relaxed); }
+    void clear(uint32_t frame, FrameFlag flag) { flags[frame].fetch_and(static_cast<uint8_t>(~flag), std::memory_order_relaxed); }
+    bool testAndClear(uint32_t frame, FrameFlag flag)
+    {
+        return (flags[frame].fetch_and(static_cast<uint8_t>(~flag), std::memory_order_relaxed) & flag) != 0;
+    }
+    void setFlags(uint32_t frame, uint8_t bits) { flags[frame].store(bits, std::memory_order_relaxed); }
+    uint8_t getFlags(uint32_t frame) const { return flags[frame].load(std::memory_order_relaxed); }
+
+    // Resident, private, base-sized and not in transit, so a replacement policy may evict it
+    bool isEvictable(uint32_t frame) const
+    {
+        return (flags[frame].load(std::memory_order_relaxed) & (PRESENT | IN_TRANSIT | SHARED | HUGE)) == PRESENT;
+    }
+
+    void assign(uint32_t frame, uint8_t bits, uint32_t ownerPID, uint32_t pageNumber)
+    {
+        ownerPIDs[frame].store(ownerPID, std::memory_order_relaxed);
+        pageNumbers[frame].store(pageNumber, std::memory_order_relaxed);
+        flags[frame].store(bits, std::memory_order_relaxed);
+    }
+
+    void reset(uint32_t frame)
+    {
+        flags[frame].store(0, std::memory_order_relaxed);
+        ownerPIDs[frame].store(NO_OWNER, std::memory_order_relaxed);
+        refCounts[frame].store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t getOwner(uint32_t frame) const { return ownerPIDs[frame].load(std::memory_order_relaxed); }
+    uint32_t getPageNumber(uint32_t frame) const { return pageNumbers[frame].load(std::memory_order_relaxed); }
+    uint64_t getLastAccess(uint32_t frame) const { return lastAccess[frame].load(std::memory_order_relaxed); }
+    void setLastAccess(uint32_t frame, uint64_t clock) { lastAccess[frame].store(clock, std::memory_order_relaxed); }
+
+    // Page table mappings of a shared frame; dropRef returns the count left
+    uint32_t getRefCount(uint32_t frame) const { return refCounts[frame].load(std::memory_order_relaxed); }
+    void addRef(uint32_t frame, uint32_t count = 1) { refCounts[frame].fetch_add(count, std::memory_order_relaxed); }
+    uint32_t dropRef(uint32_t frame) { return refCounts[frame].fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+private:
+    size_t numFrames;
+    std::unique_ptr<std::atomic<uint8_t>[]> flags;
+    std::unique_ptr<std::atomic<uint32_t>[]> ownerPIDs;
+    std::unique_ptr<std::atomic<uint32_t>[]> pageNumbers; // Virtual page held by each frame
+    std::unique_ptr<std::atomic<uint64_t>[]> lastAccess;  // Access clock value of the latest reference
+    std::unique_ptr<std::atomic<uint32_t>[]> refCounts;   // Mappings of SHARED frames
+};
+
+#endif
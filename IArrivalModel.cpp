@@ -0,0 +1,53 @@
+#include "IArrivalModel.h"
+#include "FixedArrivalModel.h"
+#include "PoissonArrivalModel.h"
+#include "BurstyArrivalModel.h"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+// Generator stream for arrivals in deterministic mode, clear of the
+// per-PID streams
+static const uint64_t ARRIVAL_STREAM = UINT64_MAX;
+
+IArrivalModel::IArrivalModel()
+    : random(Config::getInstance().isDeterministic()
+                 ? Xoshiro256(Config::getInstance().getSeed(), ARRIVAL_STREAM)
+                 : Xoshiro256((static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()()))
+{
+}
+
+std::unique_ptr<IArrivalModel> IArrivalModel::create(const std::string &name, uint32_t batchFreq,
+                                                     uint32_t burstOnCycles, uint32_t burstOffCycles)
+{
+    if (name == "fixed")
+    {
+        return std::unique_ptr<IArrivalModel>(new FixedArrivalModel(batchFreq));
+    }
+    if (name == "poisson")
+    {
+        return std::unique_ptr<IArrivalModel>(new PoissonArrivalModel(batchFreq));
+    }
+    if (name == "bursty")
+    {
+        return std::unique_ptr<IArrivalModel>(new BurstyArrivalModel(batchFreq, burstOnCycles, burstOffCycles));
+    }
+    throw std::runtime_error("Unknown arrival model: " + name);
+}
+
+uint64_t IArrivalModel::samplePoisson(double mean)
+{
+    if (mean <= 0.0)
+        return 0;
+
+    std::poisson_distribution<uint64_t> dis(mean);
+    return dis(random);
+}
+
+uint64_t IArrivalModel::sampleGap(double meanGap)
+{
+    std::exponential_distribution<double> dis(1.0 / meanGap);
+    return std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(dis(random))));
+}
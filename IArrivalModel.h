@@ -0,0 +1,41 @@
+#ifndef IARRIVAL_MODEL_H
+#define IARRIVAL_MODEL_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Xoshiro256.h"
+
+// Decides how many batch processes arrive over a span of CPU cycles. All
+// models average one arrival per batch-process-freq cycles; they differ in
+// how the arrivals are spread out.
+class IArrivalModel
+{
+public:
+    IArrivalModel();
+    virtual ~IArrivalModel() = default;
+
+    // Arrivals during the cycles (from, to]
+    virtual uint64_t arrivals(uint64_t from, uint64_t to) = 0;
+
+    // The next cycle after the given one worth asking about arrivals; the
+    // event engine skips the cycles in between
+    virtual uint64_t nextArrival(uint64_t after) = 0;
+    virtual std::string getName() const = 0;
+
+    // Creates the model named by the arrival-model config value
+    static std::unique_ptr<IArrivalModel> create(const std::string &name, uint32_t batchFreq,
+                                                 uint32_t burstOnCycles, uint32_t burstOffCycles);
+
+protected:
+    // Seeded from the config seed in deterministic mode
+    Xoshiro256 random;
+
+    uint64_t samplePoisson(double mean);
+
+    // Whole cycles until the next event of a Poisson process with the given
+    // mean gap, at least one
+    uint64_t sampleGap(double meanGap);
+};
+
+#endif
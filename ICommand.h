@@ -14,7 +14,8 @@ public:
     ICommand(int pid, CommandType commandType);
     virtual ~ICommand() = default;
 
-    virtual void execute() = 0;
+    // Runs on the given core
+    virtual void execute(int coreID) = 0;
     virtual std::string getLogDetails() const = 0;
 
     CommandType getCommandType() const { return commandType; }
@@ -0,0 +1,27 @@
+#include "IFlatAllocator.h"
+#include "FirstFitAllocator.h"
+#include "BuddyAllocator.h"
+#include "SegregatedFitAllocator.h"
+#include <stdexcept>
+
+IFlatAllocator::IFlatAllocator(AllocatorType allocatorType, size_t totalSize)
+    : allocatorType(allocatorType), totalSize(totalSize)
+{
+}
+
+std::unique_ptr<IFlatAllocator> IFlatAllocator::create(const std::string &name, size_t totalSize)
+{
+    if (name == "firstfit")
+    {
+        return std::unique_ptr<IFlatAllocator>(new FirstFitAllocator(totalSize));
+    }
+    if (name == "buddy")
+    {
+        return std::unique_ptr<IFlatAllocator>(new BuddyAllocator(totalSize));
+    }
+    if (name == "segregated")
+    {
+        return std::unique_ptr<IFlatAllocator>(new SegregatedFitAllocator(totalSize));
+    }
+    throw std::runtime_error("Unknown flat allocator: " + name);
+}
@@ -0,0 +1,59 @@
+#ifndef IFLAT_ALLOCATOR_H
+#define IFLAT_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One entry of an allocator's address map
+struct FlatBlock
+{
+    size_t address;
+    size_t size;
+    bool isFree;
+};
+
+class IFlatAllocator
+{
+public:
+    enum AllocatorType
+    {
+        FIRST_FIT,
+        BUDDY,
+        SEGREGATED_FIT
+    };
+
+    IFlatAllocator(AllocatorType allocatorType, size_t totalSize);
+    virtual ~IFlatAllocator() = default;
+
+    // Reserves at least size bytes; blockSize receives the bytes actually reserved
+    virtual bool allocate(size_t size, size_t &address, size_t &blockSize) = 0;
+    virtual void release(size_t address) = 0;
+    virtual std::string getName() const = 0;
+
+    // Fragmentation statistics for vmstat
+    virtual size_t getFreeBlockCount() const = 0;
+    virtual size_t getLargestFreeBlock() const = 0;
+
+    // Every free and live block in address order, for memory snapshots
+    virtual void getBlocks(std::vector<FlatBlock> &blocks) const = 0;
+
+    // Slides live blocks to the bottom of memory, recording (old, new) addresses.
+    // Returns the bytes moved; allocators that cannot relocate blocks move nothing.
+    virtual bool canCompact() const { return false; }
+    virtual size_t compact(std::vector<std::pair<size_t, size_t>> & /*relocations*/) { return 0; }
+
+    // Creates the allocator named by the flat-allocator config value
+    static std::unique_ptr<IFlatAllocator> create(const std::string &name, size_t totalSize);
+
+    AllocatorType getAllocatorType() const { return allocatorType; }
+    size_t getTotalSize() const { return totalSize; }
+
+protected:
+    AllocatorType allocatorType;
+    size_t totalSize;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "IReplacementPolicy.h"
+#include "FIFOPolicy.h"
+#include "ClockPolicy.h"
+#include "SecondChancePolicy.h"
+#include "LRUPolicy.h"
+#include <stdexcept>
+
+IReplacementPolicy::IReplacementPolicy(PolicyType policyType)
+    : policyType(policyType), references(0), faults(0), evictions(0)
+{
+}
+
+std::unique_ptr<IReplacementPolicy> IReplacementPolicy::create(const std::string &name, size_t numFrames)
+{
+    if (name == "fifo")
+    {
+        return std::unique_ptr<IReplacementPolicy>(new FIFOPolicy(numFrames));
+    }
+    if (name == "clock")
+    {
+        return std::unique_ptr<IReplacementPolicy>(new ClockPolicy(numFrames));
+    }
+    if (name == "second-chance")
+    {
+        return std::unique_ptr<IReplacementPolicy>(new SecondChancePolicy(numFrames));
+    }
+    if (name == "lru")
+    {
+        return std::unique_ptr<IReplacementPolicy>(new LRUPolicy(numFrames));
+    }
+    throw std::runtime_error("Unknown page replacement policy: " + name);
+}
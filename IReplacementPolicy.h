@@ -0,0 +1,55 @@
+#ifndef IREPLACEMENT_POLICY_H
+#define IREPLACEMENT_POLICY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class FrameTable;
+
+class IReplacementPolicy
+{
+public:
+    enum PolicyType
+    {
+        FIFO,
+        CLOCK,
+        SECOND_CHANCE,
+        LRU
+    };
+
+    IReplacementPolicy(PolicyType policyType);
+    virtual ~IReplacementPolicy() = default;
+
+    // Frame lifecycle notifications from the MemoryManager
+    virtual void onFrameLoaded(uint32_t frame) = 0;
+    virtual void onFrameFreed(uint32_t frame) = 0;
+
+    // Picks a resident frame to evict; returns false if no frame is resident
+    virtual bool selectVictim(FrameTable &frameTable, uint32_t &victim) = 0;
+    virtual std::string getName() const = 0;
+
+    // Creates the policy named by the page-replacement config value
+    static std::unique_ptr<IReplacementPolicy> create(const std::string &name, size_t numFrames);
+
+    // Fault-rate statistics for vmstat, updated without the policy lock
+    void recordReference() { references.fetch_add(1, std::memory_order_relaxed); }
+    void recordFault() { faults.fetch_add(1, std::memory_order_relaxed); }
+    void recordEviction() { evictions.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t getReferences() const { return references.load(std::memory_order_relaxed); }
+    uint64_t getFaults() const { return faults.load(std::memory_order_relaxed); }
+    uint64_t getEvictions() const { return evictions.load(std::memory_order_relaxed); }
+
+    PolicyType getPolicyType() const { return policyType; }
+
+protected:
+    PolicyType policyType;
+
+    std::atomic<uint64_t> references;
+    std::atomic<uint64_t> faults;
+    std::atomic<uint64_t> evictions;
+};
+
+#endif
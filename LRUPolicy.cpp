@@ -0,0 +1,61 @@
+#include "LRUPolicy.h"
+#include "FrameTable.h"
+#include "Config.h"
+#include "Xoshiro256.h"
+
+// Generator stream for victim sampling in deterministic mode, clear of the
+// per-PID streams
+static const uint64_t SAMPLING_STREAM = UINT64_MAX - 1;
+
+LRUPolicy::LRUPolicy(size_t /*numFrames*/)
+    : IReplacementPolicy(LRU),
+      gen(Config::getInstance().isDeterministic()
+              ? static_cast<std::mt19937::result_type>(Xoshiro256(Config::getInstance().getSeed(), SAMPLING_STREAM)())
+              : std::random_device()())
+{
+}
+
+bool LRUPolicy::selectVictim(FrameTable &frameTable, uint32_t &victim)
+{
+    if (frameTable.empty())
+    {
+        return false;
+    }
+
+    std::uniform_int_distribution<size_t> dis(0, frameTable.size() - 1);
+    int sampled = 0;
+    bool found = false;
+
+    for (int probe = 0; probe < MAX_PROBES && sampled < SAMPLE_SIZE; ++probe)
+    {
+        uint32_t frame = static_cast<uint32_t>(dis(gen));
+        if (!frameTable.isEvictable(frame))
+        {
+            continue;
+        }
+
+        ++sampled;
+        if (!found || frameTable.getLastAccess(frame) < frameTable.getLastAccess(victim))
+        {
+            victim = frame;
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        return true;
+    }
+
+    // Mostly free frame table: fall back to an exact scan
+    for (uint32_t frame = 0; frame < frameTable.size(); ++frame)
+    {
+        if (frameTable.isEvictable(frame) &&
+            (!found || frameTable.getLastAccess(frame) < frameTable.getLastAccess(victim)))
+        {
+            victim = frame;
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,25 @@
+#ifndef LRU_POLICY_H
+#define LRU_POLICY_H
+
+#include "IReplacementPolicy.h"
+#include <random>
+
+// Sampled LRU: evicts the least recently used of a few random resident frames
+class LRUPolicy : public IReplacementPolicy
+{
+public:
+    LRUPolicy(size_t numFrames);
+
+    void onFrameLoaded(uint32_t /*frame*/) override {}
+    void onFrameFreed(uint32_t /*frame*/) override {}
+    bool selectVictim(FrameTable &frameTable, uint32_t &victim) override;
+    std::string getName() const override { return "lru"; }
+
+private:
+    static const int SAMPLE_SIZE = 8;
+    static const int MAX_PROBES = 4 * SAMPLE_SIZE;
+
+    std::mt19937 gen;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+
+// Power-of-two bucketed latency histogram; bucket i counts samples below 2^i ns
+class LatencyHistogram
+{
+public:
+    static const int NUM_BUCKETS = 32;
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void record(std::chrono::nanoseconds latency)
+    {
+        uint64_t ns = static_cast<uint64_t>(latency.count());
+        int bucket = 0;
+        while (bucket < NUM_BUCKETS - 1 && (ns >> bucket) > 0)
+        {
+            ++bucket;
+        }
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Upper bound in nanoseconds of the bucket holding the given percentile
+    uint64_t getPercentile(double percentile) const
+    {
+        uint64_t total = samples.load(std::memory_order_relaxed);
+        if (total == 0)
+        {
+            return 0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(total * percentile / 100.0);
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; ++i)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen > target)
+            {
+                return uint64_t(1) << i;
+            }
+        }
+        return uint64_t(1) << (NUM_BUCKETS - 1);
+    }
+
+    uint64_t getSamples() const { return samples.load(std::memory_order_relaxed); }
+
+    void reset()
+    {
+        for (int i = 0; i < NUM_BUCKETS; ++i)
+        {
+            buckets[i].store(0, std::memory_order_relaxed);
+        }
+        samples.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> buckets[NUM_BUCKETS];
+    std::atomic<uint64_t> samples;
+};
+
+#endif
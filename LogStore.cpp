@@ -0,0 +1,315 @@
+#include "LogStore.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const size_t LogStore::RECORD_ALIGNMENT;
+const size_t LogStore::COMPACT_RATIO;
+
+LogStore::LogStore()
+    : segmentSize(0),
+      nextSegmentID(1),
+      active(nullptr),
+      compactions(0),
+      reclaimedBytes(0)
+{
+}
+
+void LogStore::open(const std::string &path, size_t bytesPerSegment)
+{
+    close();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    basePath = path;
+    segmentSize = bytesPerSegment;
+    nextSegmentID = 1;
+    compactions = 0;
+    reclaimedBytes = 0;
+}
+
+void LogStore::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &entry : segments)
+    {
+        closeSegment(*entry.second, false);
+    }
+    segments.clear();
+    index.clear();
+    active = nullptr;
+}
+
+void LogStore::append(int pid, const char *text, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // The line is only indexed once it is written, so a failed write
+    // leaves the process's lines as they were
+    auto it = index.find(pid);
+    uint64_t sequence = it == index.end() ? 0 : it->second.first + it->second.locations.size();
+    uint64_t location = write(pid, sequence, text, length);
+    index[pid].locations.push_back(location);
+}
+
+std::vector<std::string> LogStore::tail(int pid, size_t count) const
+{
+    std::vector<std::string> result;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(pid);
+    if (it == index.end())
+        return result;
+
+    const std::vector<uint64_t> &lines = it->second.locations;
+    size_t first = lines.size() > count ? lines.size() - count : 0;
+    result.reserve(lines.size() - first);
+    for (size_t i = first; i < lines.size(); ++i)
+    {
+        const Segment &segment = *segments.at(locationSegment(lines[i]));
+        const char *record = segment.mapping + locationOffset(lines[i]);
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+        result.emplace_back(record + sizeof(header), header.length);
+    }
+    return result;
+}
+
+void LogStore::archive(int pid, size_t keep)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(pid);
+    if (it == index.end())
+        return;
+
+    Lines &lines = it->second;
+    size_t dropped = lines.locations.size() > keep ? lines.locations.size() - keep : 0;
+
+    // A process's lines are mostly adjacent, so consecutive duplicates are
+    // skipped before the sort
+    std::vector<uint32_t> touched;
+    for (size_t i = 0; i < dropped; ++i)
+    {
+        uint64_t location = lines.locations[i];
+        uint32_t id = locationSegment(location);
+        Segment &segment = *segments.at(id);
+        RecordHeader header;
+        std::memcpy(&header, segment.mapping + locationOffset(location), sizeof(header));
+        segment.liveBytes -= recordSize(header.length);
+        segment.liveRecords--;
+        if (touched.empty() || touched.back() != id)
+        {
+            touched.push_back(id);
+        }
+    }
+    if (dropped == lines.locations.size())
+    {
+        index.erase(it);
+    }
+    else
+    {
+        lines.first += dropped;
+        lines.locations.erase(lines.locations.begin(), lines.locations.begin() + dropped);
+        lines.locations.shrink_to_fit();
+    }
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (uint32_t id : touched)
+    {
+        Segment &segment = *segments.at(id);
+        if (&segment == active)
+            continue;
+
+        if (segment.liveRecords == 0)
+        {
+            reclaimedBytes += segment.used;
+            closeSegment(segment, true);
+            segments.erase(id);
+        }
+        else if (segment.liveBytes * COMPACT_RATIO < segment.used)
+        {
+            compact(segment);
+        }
+    }
+}
+
+LogStore::Stats LogStore::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Stats stats = {segments.size(), 0, 0, compactions, reclaimedBytes};
+    for (const auto &entry : segments)
+    {
+        stats.usedBytes += entry.second->used;
+        stats.liveBytes += entry.second->liveBytes;
+    }
+    return stats;
+}
+
+LogStore::Segment *LogStore::createSegment()
+{
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), ".%06u", nextSegmentID);
+
+    std::unique_ptr<Segment> segment(new Segment());
+    segment->id = nextSegmentID;
+    segment->path = basePath + suffix;
+    segment->mapping = nullptr;
+    segment->used = 0;
+    segment->liveBytes = 0;
+    segment->liveRecords = 0;
+
+#ifdef _WIN32
+    segment->mappingHandle = nullptr;
+    segment->fileHandle = CreateFileA(segment->path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                      CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (segment->fileHandle == INVALID_HANDLE_VALUE)
+    {
+        throw LogStoreException("Could not create log segment: " + segment->path);
+    }
+
+    uint64_t fileSize = segmentSize;
+    segment->mappingHandle = CreateFileMappingA(segment->fileHandle, nullptr, PAGE_READWRITE,
+                                                static_cast<DWORD>(fileSize >> 32),
+                                                static_cast<DWORD>(fileSize & 0xFFFFFFFF), nullptr);
+    if (segment->mappingHandle != nullptr)
+    {
+        segment->mapping = static_cast<char *>(MapViewOfFile(segment->mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    }
+#else
+    segment->fileDescriptor = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment->fileDescriptor < 0)
+    {
+        throw LogStoreException("Could not create log segment: " + segment->path);
+    }
+
+    if (ftruncate(segment->fileDescriptor, static_cast<off_t>(segmentSize)) == 0)
+    {
+        void *view = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fileDescriptor, 0);
+        segment->mapping = (view == MAP_FAILED) ? nullptr : static_cast<char *>(view);
+    }
+#endif
+
+    if (segment->mapping == nullptr)
+    {
+        closeSegment(*segment, true);
+        throw LogStoreException("Could not map log segment: " + segment->path);
+    }
+
+    nextSegmentID++;
+    Segment *created = segment.get();
+    segments[created->id] = std::move(segment);
+    return created;
+}
+
+// Segments that stay on disk are cut back to their records, dropping the
+// unused end of the preallocation
+void LogStore::closeSegment(Segment &segment, bool removeFile)
+{
+#ifdef _WIN32
+    if (segment.mapping != nullptr)
+    {
+        UnmapViewOfFile(segment.mapping);
+    }
+    if (segment.mappingHandle != nullptr)
+    {
+        CloseHandle(segment.mappingHandle);
+        segment.mappingHandle = nullptr;
+    }
+    if (segment.fileHandle != INVALID_HANDLE_VALUE)
+    {
+        if (!removeFile)
+        {
+            LARGE_INTEGER size;
+            size.QuadPart = static_cast<LONGLONG>(segment.used);
+            SetFilePointerEx(segment.fileHandle, size, nullptr, FILE_BEGIN);
+            SetEndOfFile(segment.fileHandle);
+        }
+        CloseHandle(segment.fileHandle);
+        segment.fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (segment.mapping != nullptr)
+    {
+        munmap(segment.mapping, segmentSize);
+    }
+    if (segment.fileDescriptor >= 0)
+    {
+        if (!removeFile && ftruncate(segment.fileDescriptor, static_cast<off_t>(segment.used)) != 0)
+        {
+            // The file keeps its zero-filled tail
+        }
+        ::close(segment.fileDescriptor);
+        segment.fileDescriptor = -1;
+    }
+#endif
+    segment.mapping = nullptr;
+
+    if (removeFile)
+    {
+        std::remove(segment.path.c_str());
+    }
+}
+
+// Appends one record to the active segment, starting a new segment when it
+// does not fit; returns the record's location
+uint64_t LogStore::write(int pid, uint64_t sequence, const char *text, size_t length)
+{
+    length = std::min(length, segmentSize - recordSize(0));
+    size_t size = recordSize(length);
+    if (!active || active->used + size > segmentSize)
+    {
+        active = createSegment();
+    }
+
+    RecordHeader header = {static_cast<uint32_t>(length), pid, sequence};
+    char *record = active->mapping + active->used;
+    std::memcpy(record, &header, sizeof(header));
+    std::memcpy(record + sizeof(header), text, length);
+
+    uint64_t location = makeLocation(active->id, active->used);
+    active->used += size;
+    active->liveBytes += size;
+    active->liveRecords++;
+    return location;
+}
+
+// Copies the segment's live records to the active segment, repoints their
+// index entries and deletes the segment. A record is live if its process's
+// index still points at it.
+void LogStore::compact(Segment &segment)
+{
+    for (size_t offset = 0; offset < segment.used;)
+    {
+        const char *record = segment.mapping + offset;
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+
+        auto it = index.find(header.pid);
+        if (it != index.end() && header.sequence >= it->second.first)
+        {
+            std::vector<uint64_t> &locations = it->second.locations;
+            uint64_t line = header.sequence - it->second.first;
+            if (line < locations.size() && locations[line] == makeLocation(segment.id, offset))
+            {
+                locations[line] = write(header.pid, header.sequence, record + sizeof(header), header.length);
+            }
+        }
+        offset += recordSize(header.length);
+    }
+
+    compactions++;
+    reclaimedBytes += segment.used - segment.liveBytes;
+    uint32_t id = segment.id;
+    closeSegment(segment, true);
+    segments.erase(id);
+}
@@ -0,0 +1,123 @@
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Segmented, append-only store of process output lines. Lines go to the
+// end of the active segment, a preallocated memory-mapped file; a full
+// segment is sealed and the next one started. Every live process has an
+// index of where each of its lines is, so reading its last N lines touches
+// N records no matter how much has been written. Archiving a process kills
+// all but its last few lines: sealed segments left empty are deleted, and
+// mostly dead ones are compacted by copying the surviving lines to the
+// active segment.
+class LogStore
+{
+public:
+    LogStore();
+    ~LogStore() { close(); }
+
+    LogStore(const LogStore &) = delete;
+    LogStore &operator=(const LogStore &) = delete;
+
+    // Segments are <basePath>.000001 and up; existing files are overwritten
+    void open(const std::string &basePath, size_t segmentSize);
+
+    // Trims every segment to the bytes in use and unmaps it; the files stay
+    void close();
+
+    void append(int pid, const char *text, size_t length);
+
+    // Up to count of the process's most recent lines, oldest first
+    std::vector<std::string> tail(int pid, size_t count) const;
+
+    // Keeps only the process's last keep lines, for a process that will log
+    // no more
+    void archive(int pid, size_t keep);
+
+    struct Stats
+    {
+        size_t segments;
+        uint64_t usedBytes; // Records written to segments still on disk
+        uint64_t liveBytes; // Records still indexed
+        uint64_t compactions;
+        uint64_t reclaimedBytes;
+    };
+    Stats getStats() const;
+
+    class LogStoreException : public std::runtime_error
+    {
+    public:
+        LogStoreException(const std::string &msg) : std::runtime_error(msg) {}
+    };
+
+private:
+    static const size_t RECORD_ALIGNMENT = 8;
+    static const size_t COMPACT_RATIO = 4; // Compact a sealed segment once live bytes fall under 1/4 of it
+
+    struct RecordHeader
+    {
+        uint32_t length; // Text bytes following the header
+        int32_t pid;
+        uint64_t sequence; // Line number within the process
+    };
+
+    struct Segment
+    {
+        uint32_t id;
+        std::string path;
+        char *mapping;
+        size_t used;
+        size_t liveBytes;
+        size_t liveRecords;
+#ifdef _WIN32
+        void *fileHandle;
+        void *mappingHandle;
+#else
+        int fileDescriptor;
+#endif
+    };
+
+    // A line's location is its segment ID in the high half and its offset
+    // in the low half
+    static uint64_t makeLocation(uint32_t segment, size_t offset) { return (static_cast<uint64_t>(segment) << 32) | offset; }
+    static uint32_t locationSegment(uint64_t location) { return static_cast<uint32_t>(location >> 32); }
+    static size_t locationOffset(uint64_t location) { return static_cast<size_t>(location & 0xFFFFFFFF); }
+
+    static size_t recordSize(size_t length)
+    {
+        return (sizeof(RecordHeader) + length + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    }
+
+    std::string basePath;
+    size_t segmentSize;
+    uint32_t nextSegmentID;
+    Segment *active;
+    std::unordered_map<uint32_t, std::unique_ptr<Segment>> segments;
+    // Where a process's lines are, oldest first. Lines dropped by archive
+    // leave the front, so locations[i] holds line first + i.
+    struct Lines
+    {
+        uint64_t first;
+        std::vector<uint64_t> locations;
+    };
+
+    std::unordered_map<int, Lines> index; // By PID
+    uint64_t compactions;
+    uint64_t reclaimedBytes;
+    mutable std::mutex mutex;
+
+    // Callers hold the mutex
+    Segment *createSegment();
+    void closeSegment(Segment &segment, bool removeFile);
+    uint64_t write(int pid, uint64_t sequence, const char *text, size_t length);
+    void compact(Segment &segment);
+};
+
+#endif
@@ -3,6 +3,10 @@
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
+#include <cstring>
+
+const uint32_t MemoryManager::INVALID_FRAME;
+const uint32_t FrameTable::NO_OWNER;
 
 void MemoryManager::initialize()
 {
@@ -14,6 +18,7 @@ void MemoryManager::initialize()
     auto &config = Config::getInstance();
     totalMemory = config.getMaxOverallMem() * 1024; // Convert KB to bytes
     pageSize = config.getMemPerFrame() * 1024;      // Convert KB to bytes
+    singleThreaded = config.isSingleThreaded();
 
     // Determine allocation strategy
     usePageBasedAllocation = (totalMemory != pageSize);
@@ -22,330 +27,1503 @@ void MemoryManager::initialize()
     {
         // Initialize page table
         size_t numFrames = totalMemory / pageSize;
-        pageTable.resize(numFrames, {0, false, std::weak_ptr<Process>()});
+        frameTable.resize(numFrames);
+        replacementPolicy = IReplacementPolicy::create(config.getPageReplacement(), numFrames);
+
+        // Frames are backed by real bytes because eviction, swap-in and
+        // copy-on-write move page contents through the compressed pool and
+        // the swap file; their latency and ratio stats come from those
+        // transfers. The buffer is left uninitialized, so the host only
+        // commits a frame's pages once the frame is first zeroed or filled.
+        physicalMemory.reset(new char[numFrames * pageSize]);
+
+        // Huge frames take an aligned region at the top of memory; the base
+        // frame pool covers everything below it
+        hugeFrameFactor = config.getHugeFrameFactor();
+        size_t numHugeFrames = 0;
+        if (hugeFrameFactor > 1)
+        {
+            size_t regionFrames = numFrames * config.getHugeFrameRegion() / 100;
+            size_t regionStart = (numFrames - regionFrames + hugeFrameFactor - 1) / hugeFrameFactor * hugeFrameFactor;
+            numHugeFrames = regionStart < numFrames ? (numFrames - regionStart) / hugeFrameFactor : 0;
+        }
+        hugeRegionStart = static_cast<uint32_t>(numFrames - numHugeFrames * hugeFrameFactor);
+        imageFrameLimit = std::max<size_t>(1, hugeRegionStart / IMAGE_FRAME_SHARE);
+        hugeFramePool.initialize(numHugeFrames, 1);
+        hugeFrames = numHugeFrames;
+
+        // One frame pool and page table shard per core
+        size_t numShards = std::max<size_t>(1, config.getNumCPU());
+        framePool.initialize(hugeRegionStart, numShards);
+        pageTableShards.clear();
+        for (size_t i = 0; i < numShards; ++i)
+        {
+            pageTableShards.push_back(std::unique_ptr<PageTableShard>(new PageTableShard));
+        }
+
+        coreTLBs.clear();
+        for (int core = 0; core < config.getNumCPU(); ++core)
+        {
+            coreTLBs.push_back(std::unique_ptr<CoreTLB>(new CoreTLB));
+        }
+        tlbMissPenalty = config.getTLBMissPenalty();
+
+        size_t swapBytes = static_cast<size_t>(config.getSwapSize()) * 1024;
+        swapStore.open(config.getSwapFile(), pageSize, swapBytes / pageSize);
+
+        // The zero frame and the frame of a page-in under way are never
+        // available to hold a committed page
+        size_t privateFrames = hugeRegionStart > imageFrameLimit + 2 ? hugeRegionStart - imageFrameLimit - 2 : 0;
+        commitLimit = swapStore.getNumSlots() + privateFrames;
+        compressedPool.initialize(pageSize, totalMemory / 100 * config.getCompressedPool());
     }
     else
     {
-        // Initialize single memory block for flat allocation
-        memoryBlocks.push_back({0, totalMemory, true, std::weak_ptr<Process>()});
+        flatAllocator = IFlatAllocator::create(config.getFlatAllocator(), totalMemory);
+    }
+
+    if (config.getSnapshotInterval() > 0)
+    {
+        snapshotStream.open(config.getSnapshotFile(), std::ios::binary | std::ios::trunc);
+        if (!snapshotStream)
+        {
+            throw std::runtime_error("Could not create snapshot file: " + config.getSnapshotFile());
+        }
+
+        std::vector<char> header;
+        MemorySnapshot::encodeFileHeader(header);
+        snapshotStream.write(header.data(), header.size());
     }
 
     usedMemory = 0;
+    activeMemory = 0;
+    requestedMemory = 0;
+    compactions = 0;
+    autoCompactions = 0;
+    compactedBytes = 0;
+    accessClock = 0;
     pagesPagedIn = 0;
     pagesPagedOut = 0;
+    faultStalls = 0;
+    prefetchRequests = 0;
+    prefetchHits = 0;
+    sharedFrames = 0;
+    sharedMappings = 0;
+    cowFaults = 0;
+    imageReclaimHand = 0;
+    imageReclaims = 0;
+    workingSetDemand = 0;
+    committedPages = 0;
+    hugeMappings = 0;
+    hugeCarves = 0;
+    hugeReassemblies = 0;
+    hugeFallbacks = 0;
+    carvedHugeFrames.clear();
     initialized = true;
+
+    if (usePageBasedAllocation)
+    {
+        // Untouched data pages of every process map this one read-only frame
+        std::vector<uint32_t> reserved;
+        zeroFrame = INVALID_FRAME;
+        if (frameTable.size() > 1 && framePool.take(0, 1, reserved))
+        {
+            zeroFrame = reserved.front();
+            std::memset(getFrameData(zeroFrame), 0, pageSize);
+            frameTable.assign(zeroFrame, FrameTable::PRESENT | FrameTable::SHARED, FrameTable::NO_OWNER, 0);
+            usedMemory += pageSize;
+            activeMemory += pageSize;
+            sharedFrames = 1;
+        }
+
+        if (!singleThreaded)
+        {
+            ioRunning = true;
+            ioThread = std::thread(&MemoryManager::ioLoop, this);
+        }
+    }
+
+    if (snapshotStream.is_open() && !singleThreaded)
+    {
+        snapshotRunning = true;
+        snapshotThread = std::thread(&MemoryManager::snapshotLoop, this);
+    }
 }
 
-bool MemoryManager::allocateMemory(std::shared_ptr<Process> process)
+void MemoryManager::shutdown()
 {
-    if (!initialized)
     {
-        throw std::runtime_error("Memory Manager not initialized");
+        std::lock_guard<std::mutex> lock(ioMutex);
+        ioRunning = false;
     }
+    ioCv.notify_all();
 
-    size_t requiredBytes = process->getMemoryRequirement() * 1024;
+    if (ioThread.joinable())
+    {
+        ioThread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        snapshotRunning = false;
+    }
+    snapshotCv.notify_all();
 
-    std::lock_guard<std::mutex> lock(memoryMutex); // Single lock scope
+    if (snapshotThread.joinable())
+    {
+        snapshotThread.join();
+    }
+    if (snapshotStream.is_open())
+    {
+        snapshotStream.close();
+    }
+}
+
+void MemoryManager::requestSnapshot(uint64_t cycle)
+{
+    if (singleThreaded)
+    {
+        if (snapshotStream.is_open())
+        {
+            MemorySnapshot snapshot;
+            std::vector<char> record;
+            writeSnapshot(cycle, snapshot, record);
+        }
+        return;
+    }
 
-    // Calculate active memory within the lock
-    size_t activeMemory = 0;
-    for (const auto &pair : processPages)
     {
-        auto proc = pageTable[pair.second[0]].process.lock();
-        if (proc && proc->getState() != Process::WAITING)
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        if (!snapshotRunning)
+            return;
+
+        // A writer that falls behind loses snapshots rather than stalling cores
+        if (snapshotRequests.size() >= MAX_PENDING_SNAPSHOTS)
         {
-            activeMemory += proc->getMemoryRequirement() * 1024;
+            snapshotsDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
+        snapshotRequests.push_back(cycle);
+    }
+    snapshotCv.notify_one();
+}
+
+void MemoryManager::snapshotLoop()
+{
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    MemorySnapshot snapshot;
+    std::vector<char> record;
+
+    while (snapshotRunning)
+    {
+        snapshotCv.wait(lock, [this]
+                        { return !snapshotRunning || !snapshotRequests.empty(); });
+
+        if (!snapshotRunning)
+            break;
+
+        uint64_t cycle = snapshotRequests.front();
+        snapshotRequests.pop_front();
+
+        lock.unlock();
+        writeSnapshot(cycle, snapshot, record);
+        lock.lock();
     }
+}
+
+void MemoryManager::writeSnapshot(uint64_t cycle, MemorySnapshot &snapshot, std::vector<char> &record)
+{
+    captureSnapshot(cycle, snapshot);
+    record.clear();
+    snapshot.encode(record);
+    snapshotStream.write(record.data(), record.size());
+    snapshotStream.flush();
+    snapshotsWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Frame flags and owners are read with relaxed loads, so a paged snapshot
+// may straddle an in-flight page-in; each shard's page tables are copied
+// under its lock
+void MemoryManager::captureSnapshot(uint64_t cycle, MemorySnapshot &snapshot)
+{
+    snapshot.cycle = cycle;
+    snapshot.isPaged = usePageBasedAllocation;
+    snapshot.pageSize = static_cast<uint32_t>(pageSize);
+    snapshot.totalBytes = totalMemory;
+    snapshot.frames.clear();
+    snapshot.processes.clear();
+    snapshot.blocks.clear();
 
-    // If not enough memory available, swap out oldest process
-    while (activeMemory + requiredBytes > totalMemory)
+    if (usePageBasedAllocation)
     {
-        bool swapped = swapOutOldestProcess();
-        if (!swapped)
+        snapshot.usedBytes = getUsedMemory();
+        snapshot.largestFreeBlock = hugeFramePool.getFreeFrames() > 0 ? getHugeFrameSize()
+                                    : framePool.getFreeFrames() > 0 ? pageSize : 0;
+        snapshot.internalFragmentation = 0;
+        snapshot.externalFragmentation = 0;
+
+        snapshot.frames.resize(frameTable.size());
+        for (uint32_t frame = 0; frame < frameTable.size(); ++frame)
         {
-            return false; // Failed to free enough memory
+            MemorySnapshot::Frame &entry = snapshot.frames[frame];
+            entry.flags = frameTable.getFlags(frame);
+            entry.owner = frameTable.getOwner(frame);
+            entry.pageNumber = frameTable.getPageNumber(frame);
         }
 
-        // Recalculate active memory after swap
-        activeMemory = 0;
-        for (const auto &pair : processPages)
+        for (auto &shard : pageTableShards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (const auto &pair : shard->processes)
+            {
+                const ProcessPageTable &table = pair.second;
+                MemorySnapshot::ProcessEntry entry;
+                entry.pid = static_cast<uint32_t>(pair.first);
+                entry.address = 0;
+                entry.size = static_cast<uint64_t>(table.frames.size()) * pageSize * table.frameFactor;
+                entry.residentPages = static_cast<uint32_t>(
+                    std::count_if(table.frames.begin(), table.frames.end(), [](uint32_t frame)
+                                  { return frame != INVALID_FRAME; }));
+                entry.workingSet = static_cast<uint32_t>(table.workingSet);
+                snapshot.processes.push_back(entry);
+            }
+        }
+    }
+    else
+    {
+        std::vector<FlatBlock> blocks;
         {
-            auto proc = pageTable[pair.second[0]].process.lock();
-            if (proc && proc->getState() != Process::WAITING)
+            std::lock_guard<std::mutex> lock(memoryMutex);
+            snapshot.usedBytes = usedMemory;
+            snapshot.largestFreeBlock = flatAllocator->getLargestFreeBlock();
+            snapshot.internalFragmentation = usedMemory - requestedMemory;
+            snapshot.externalFragmentation = static_cast<uint16_t>(getExternalFragmentation() * 100.0);
+            flatAllocator->getBlocks(blocks);
+
+            for (const auto &pair : flatAllocations)
             {
-                activeMemory += proc->getMemoryRequirement() * 1024;
+                MemorySnapshot::ProcessEntry entry;
+                entry.pid = static_cast<uint32_t>(pair.first);
+                entry.address = pair.second.address;
+                entry.size = pair.second.size;
+                entry.residentPages = 0;
+                entry.workingSet = 0;
+                snapshot.processes.push_back(entry);
             }
         }
+
+        for (const auto &block : blocks)
+        {
+            MemorySnapshot::Block entry;
+            entry.address = block.address;
+            entry.size = block.size;
+            entry.isFree = block.isFree;
+            snapshot.blocks.push_back(entry);
+        }
+    }
+
+    std::sort(snapshot.processes.begin(), snapshot.processes.end(),
+              [](const MemorySnapshot::ProcessEntry &a, const MemorySnapshot::ProcessEntry &b)
+              { return a.pid < b.pid; });
+}
+
+bool MemoryManager::allocateMemory(std::shared_ptr<Process> process)
+{
+    if (!initialized)
+    {
+        throw std::runtime_error("Memory Manager not initialized");
     }
 
-    // Perform allocation
-    bool success = usePageBasedAllocation ? allocatePaged(process) : allocateFlat(process);
-    if (success)
+    if (usePageBasedAllocation)
     {
-        usedMemory = activeMemory + requiredBytes;
+        return allocatePaged(process);
     }
-    return success;
+
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    return allocateFlat(process);
 }
 
+// Caller holds memoryMutex
 bool MemoryManager::allocateFlat(std::shared_ptr<Process> process)
 {
     size_t requiredBytes = process->getMemoryRequirement() * 1024; // Convert KB to bytes
 
-    for (auto &block : memoryBlocks)
+    // When memory is full the oldest process is swapped out, as before
+    // paging existed, until the block fits or nothing is left to take
+    FlatAllocation allocation;
+    while (!tryAllocateFlat(requiredBytes, allocation))
     {
-        if (block.isFree && block.size >= requiredBytes)
-        {
-            // Split block if necessary
-            if (block.size > requiredBytes)
-            {
-                MemoryBlock newBlock{
-                    block.startAddress + requiredBytes,
-                    block.size - requiredBytes,
-                    true,
-                    std::weak_ptr<Process>()};
-                block.size = requiredBytes;
-                memoryBlocks.push_back(newBlock);
-            }
+        if (!swapOutOldestFlat())
+            return false;
+    }
 
-            block.isFree = false;
-            block.process = process;
-            usedMemory += requiredBytes; // Update used memory
-            return true;
+    allocation.requested = requiredBytes;
+    allocation.process = process;
+    flatAllocations[process->getPID()] = allocation;
+    usedMemory += allocation.size;
+    requestedMemory += requiredBytes;
+    return true;
+}
+
+bool MemoryManager::tryAllocateFlat(size_t requiredBytes, FlatAllocation &allocation)
+{
+    if (flatAllocator->allocate(requiredBytes, allocation.address, allocation.size))
+        return true;
+
+    // Enough memory is free but scattered: compact once and retry
+    uint32_t threshold = Config::getInstance().getCompactionThreshold();
+    if (threshold == 0 || !flatAllocator->canCompact() ||
+        totalMemory - usedMemory < requiredBytes || getExternalFragmentation() < threshold)
+    {
+        return false;
+    }
+
+    compactFlat();
+    autoCompactions++;
+    return flatAllocator->allocate(requiredBytes, allocation.address, allocation.size);
+}
+
+// Releases the block of the oldest process not already waiting. Flat mode
+// does not model residency, so the process keeps running without it and
+// has nothing to release when it finishes. Caller holds memoryMutex.
+bool MemoryManager::swapOutOldestFlat()
+{
+    auto oldest = flatAllocations.end();
+    std::chrono::system_clock::time_point oldestTime = std::chrono::system_clock::now();
+    for (auto it = flatAllocations.begin(); it != flatAllocations.end(); ++it)
+    {
+        std::shared_ptr<Process> process = it->second.process.lock();
+        if (process && process->getState() != Process::WAITING && process->getCreationTime() < oldestTime)
+        {
+            oldest = it;
+            oldestTime = process->getCreationTime();
         }
     }
 
-    return false;
+    if (oldest == flatAllocations.end())
+        return false;
+
+    flatAllocator->release(oldest->second.address);
+    usedMemory -= oldest->second.size;
+    requestedMemory -= oldest->second.requested;
+    flatAllocations.erase(oldest);
+    flatSwapOuts++;
+    return true;
 }
 
 bool MemoryManager::allocatePaged(std::shared_ptr<Process> process)
 {
     size_t requiredBytes = process->getMemoryRequirement() * 1024;
     size_t numPagesNeeded = (requiredBytes + pageSize - 1) / pageSize;
-    std::vector<uint32_t> allocatedFrames;
+    size_t codePages = std::min((process->getCodeSize() + pageSize - 1) / pageSize, numPagesNeeded);
+    int pid = process->getPID();
+
+    PageTableShard &shard = getShard(pid);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    ProcessPageTable &entry = shard.processes[pid];
+    entry.workingSet = 0;
+    entry.evictedReferenced = 0;
+    entry.committedPages = 0;
+
+    // Large processes get huge pages while the region has room for them
+    if (hugeFrameFactor > 1 && requiredBytes >= static_cast<size_t>(Config::getInstance().getHugeFrameThreshold()) * 1024)
+    {
+        if (allocateHuge(entry, pid, requiredBytes))
+            return true;
+        hugeFallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    if (findFreePages(numPagesNeeded, allocatedFrames))
+    // Text pages are never written, except the last one when data shares it
+    size_t privatePages = numPagesNeeded - std::min(process->getCodeSize() / pageSize, numPagesNeeded);
+    size_t committed = committedPages.load(std::memory_order_relaxed);
+    do
     {
-        processPages[process->getPID()] = allocatedFrames;
-        for (uint32_t frame : allocatedFrames)
+        if (committed + privatePages > commitLimit)
         {
-            pageTable[frame].isPresent = true;
-            pageTable[frame].process = process;
+            shard.processes.erase(pid);
+            return false;
         }
-        pagesPagedIn += numPagesNeeded;
-        return true;
+    } while (!committedPages.compare_exchange_weak(committed, committed + privatePages, std::memory_order_relaxed));
+    entry.committedPages = privatePages;
+
+    entry.frames.assign(numPagesNeeded, INVALID_FRAME);
+    entry.swapSlots.assign(numPagesNeeded, SwapStore::INVALID_SLOT);
+    entry.imageIDs.resize(codePages);
+    for (size_t page = 0; page < codePages; ++page)
+    {
+        entry.imageIDs[page] = acquireImage(process->getTextPageKey(page, pageSize));
     }
+    entry.frameFactor = 1;
 
-    return false;
+    // Share text another process already loaded and load the rest into
+    // whatever frames are free right now, up to the text limit; anything
+    // left over is demand paged by the I/O thread so admission never waits
+    // on eviction
+    for (uint32_t page = 0; page < codePages; ++page)
+    {
+        if (mapImagePage(entry, page))
+            continue;
+
+        std::vector<uint32_t> frame;
+        if (imageFramesFull() || !framePool.take(static_cast<size_t>(pid), 1, frame))
+            continue;
+
+        reserveFrame(frame.front(), pid, page);
+        std::memset(getFrameData(frame.front()), 0, pageSize);
+        installImagePage(frame.front(), entry, page);
+    }
+
+    // Data pages read as zeros until their first write breaks copy-on-write
+    if (zeroFrame != INVALID_FRAME)
+    {
+        for (size_t page = codePages; page < numPagesNeeded; ++page)
+        {
+            mapShared(zeroFrame, entry, static_cast<uint32_t>(page));
+        }
+    }
+
+    return true;
 }
 
-void MemoryManager::deallocateMemory(std::shared_ptr<Process> process)
+// Caller holds the process's shard mutex. Huge pages are private and stay
+// resident until the process exits, so their text is not shared with other
+// processes and nothing is ever paged out.
+bool MemoryManager::allocateHuge(ProcessPageTable &entry, int pid, size_t requiredBytes)
 {
-    std::lock_guard<std::mutex> lock(memoryMutex);
-
-    if (!process)
-        return;
+    size_t hugeFrameSize = getHugeFrameSize();
+    size_t numPages = (requiredBytes + hugeFrameSize - 1) / hugeFrameSize;
 
-    if (usePageBasedAllocation)
+    std::vector<uint32_t> taken;
+    if (!hugeFramePool.take(0, numPages, taken))
     {
-        auto it = processPages.find(process->getPID());
-        if (it != processPages.end())
+        uint32_t index;
+        while (taken.size() < numPages && reassembleHugeFrame(index))
         {
-            // Only update memory usage if process was active
-            if (process->getState() != Process::WAITING)
-            {
-                size_t memToFree = process->getMemoryRequirement() * 1024;
-                if (usedMemory >= memToFree)
-                {
-                    usedMemory -= memToFree;
-                }
-            }
+            taken.push_back(index);
+        }
 
-            for (uint32_t frame : it->second)
+        if (taken.size() < numPages)
+        {
+            for (uint32_t index : taken)
             {
-                pageTable[frame].isPresent = false;
-                pageTable[frame].process.reset();
+                hugeFramePool.release(index);
             }
-            processPages.erase(it);
+            return false;
         }
     }
-    else
+
+    entry.frames.resize(numPages);
+    entry.swapSlots.assign(numPages, SwapStore::INVALID_SLOT);
+    entry.imageIDs.clear();
+    entry.frameFactor = hugeFrameFactor;
+
+    // Every base frame of a huge frame is marked, so none is ever treated as free
+    for (uint32_t page = 0; page < numPages; ++page)
     {
-        // For flat memory
-        for (auto &block : memoryBlocks)
+        uint32_t head = hugeRegionStart + taken[page] * hugeFrameFactor;
+        std::memset(getFrameData(head), 0, hugeFrameSize);
+        for (uint32_t i = 0; i < hugeFrameFactor; ++i)
         {
-            if (!block.process.expired() && block.process.lock() == process)
-            {
-                // Only update memory usage if process was active
-                if (process->getState() != Process::WAITING)
-                {
-                    if (usedMemory >= block.size)
-                    {
-                        usedMemory -= block.size;
-                    }
-                }
-                block.isFree = true;
-                block.process.reset();
-            }
+            frameTable.assign(head + i, FrameTable::PRESENT | FrameTable::HUGE, static_cast<uint32_t>(pid),
+                              page * hugeFrameFactor + i);
         }
-        coalesceFreeBlocks();
+        entry.frames[page] = head;
     }
+
+    usedMemory.fetch_add(numPages * hugeFrameSize, std::memory_order_relaxed);
+    activeMemory.fetch_add(numPages * hugeFrameSize, std::memory_order_relaxed);
+    hugeMappings.fetch_add(numPages, std::memory_order_relaxed);
+    return true;
 }
 
-void MemoryManager::coalesceFreeBlocks()
+// Caller holds the process's shard mutex
+void MemoryManager::releaseHuge(ProcessPageTable &entry)
 {
-    bool merged;
-    do
+    size_t hugeFrameSize = getHugeFrameSize();
+    for (uint32_t head : entry.frames)
     {
-        merged = false;
-        for (auto it = memoryBlocks.begin(); it != memoryBlocks.end() - 1; ++it)
+        for (uint32_t i = 0; i < hugeFrameFactor; ++i)
         {
-            auto next = it + 1;
-            if (it->isFree && next->isFree)
-            {
-                it->size += next->size;
-                memoryBlocks.erase(next);
-                merged = true;
-                break;
-            }
+            frameTable.reset(head + i);
         }
-    } while (merged);
+        hugeFramePool.release((head - hugeRegionStart) / hugeFrameFactor);
+    }
+
+    usedMemory.fetch_sub(entry.frames.size() * hugeFrameSize, std::memory_order_relaxed);
+    activeMemory.fetch_sub(entry.frames.size() * hugeFrameSize, std::memory_order_relaxed);
+    hugeMappings.fetch_sub(entry.frames.size(), std::memory_order_relaxed);
+    entry.frames.clear();
+}
+
+// Splits a free huge frame into base frames once the base pool is empty
+// and every resident base page is pinned. The split lasts until all of its
+// base frames are free again and a huge page needs the space.
+bool MemoryManager::carveHugeFrame()
+{
+    std::vector<uint32_t> taken;
+    if (!hugeFramePool.take(0, 1, taken))
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(hugeMutex);
+        carvedHugeFrames.push_back(taken.front());
+    }
+
+    uint32_t head = hugeRegionStart + taken.front() * hugeFrameFactor;
+    for (uint32_t i = 0; i < hugeFrameFactor; ++i)
+    {
+        framePool.release(head + i);
+    }
+
+    hugeFrames.fetch_sub(1, std::memory_order_relaxed);
+    hugeCarves.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-bool MemoryManager::findFreePages(size_t numPages, std::vector<uint32_t> &allocatedFrames)
+// Rebuilds a carved huge frame whose base frames are all free again; the
+// caller owns the returned huge frame
+bool MemoryManager::reassembleHugeFrame(uint32_t &index)
 {
-    allocatedFrames.clear();
+    std::lock_guard<std::mutex> lock(hugeMutex);
 
-    for (size_t i = 0; i < pageTable.size(); i++)
+    for (auto it = carvedHugeFrames.begin(); it != carvedHugeFrames.end(); ++it)
     {
-        if (!pageTable[i].isPresent)
+        if (framePool.reclaim(hugeRegionStart + *it * hugeFrameFactor, hugeFrameFactor))
         {
-            allocatedFrames.push_back(i);
-            if (allocatedFrames.size() == numPages)
-            {
-                return true;
-            }
+            index = *it;
+            carvedHugeFrames.erase(it);
+            hugeFrames.fetch_add(1, std::memory_order_relaxed);
+            hugeReassemblies.fetch_add(1, std::memory_order_relaxed);
+            return true;
         }
     }
-
     return false;
 }
 
-bool MemoryManager::swapOutOldestProcess()
+bool MemoryManager::accessMemory(int pid, size_t virtualAddress, bool isWrite, int coreID)
 {
-    // Already locked by allocateMemory
-    std::shared_ptr<Process> oldestProcess = nullptr;
-    std::chrono::system_clock::time_point oldestTime = std::chrono::system_clock::now();
-    size_t memToFree = 0;
-    size_t numPages = 0;
-    int oldestPID = -1;
+    if (!initialized || !usePageBasedAllocation)
+        return true;
 
-    if (usePageBasedAllocation)
+    CoreTLB *core = (coreID >= 0 && static_cast<size_t>(coreID) < coreTLBs.size()) ? coreTLBs[coreID].get() : nullptr;
+
+    // A TLB hit skips the page table; shootdowns take the same lock, so the
+    // frame cannot be unmapped while its bits are updated. TLB page numbers
+    // are in the page size of the process the core switched to, so any
+    // other process bypasses the TLB.
+    if (core)
     {
-        for (const auto &pair : processPages)
+        std::lock_guard<std::mutex> tlbLock(core->mutex);
+        if (core->pid != pid)
+        {
+            core = nullptr;
+        }
+        else
         {
-            for (uint32_t frame : pair.second)
+            uint32_t frame;
+            size_t pageNumber = virtualAddress / (pageSize * core->frameFactor);
+            if (core->tlb.lookup(static_cast<uint32_t>(pid), static_cast<uint32_t>(pageNumber), isWrite, frame))
             {
-                if (!pageTable[frame].process.expired())
-                {
-                    auto process = pageTable[frame].process.lock();
-                    if (process && process->getState() != Process::WAITING &&
-                        process->getCreationTime() < oldestTime)
-                    {
-                        oldestProcess = process;
-                        oldestTime = process->getCreationTime();
-                        oldestPID = process->getPID();
-                        memToFree = process->getMemoryRequirement() * 1024;
-                        numPages = pair.second.size();
-                    }
-                }
+                touchFrame(frame, isWrite);
+                return true;
             }
+            core->pendingPenalty.fetch_add(tlbMissPenalty, std::memory_order_relaxed);
+            core->penaltyCycles.fetch_add(tlbMissPenalty, std::memory_order_relaxed);
         }
     }
-    else
+
+    PageTableShard &shard = getShard(pid);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.processes.find(pid);
+    if (it == shard.processes.end())
+        return true;
+
+    ProcessPageTable &entry = it->second;
+    size_t pageNumber = virtualAddress / (pageSize * entry.frameFactor);
+    if (pageNumber >= entry.frames.size())
+        return true;
+
+    uint32_t frame = entry.frames[pageNumber];
+
+    // Text another process already loaded is mapped without any I/O
+    if (frame == INVALID_FRAME && pageNumber < entry.imageIDs.size() &&
+        mapImagePage(entry, static_cast<uint32_t>(pageNumber)))
+    {
+        frame = entry.frames[pageNumber];
+    }
+
+    bool breaksSharing = isWrite && frame != INVALID_FRAME && frameTable.test(frame, FrameTable::SHARED);
+    if (frame == INVALID_FRAME || breaksSharing)
     {
-        for (const auto &block : memoryBlocks)
+        // The caller retries next cycle; only the first miss counts as a fault
+        faultStalls.fetch_add(1, std::memory_order_relaxed);
+        if (submitPageIn(pid, static_cast<uint32_t>(pageNumber), false, isWrite))
         {
-            if (!block.process.expired())
+            replacementPolicy->recordReference();
+            replacementPolicy->recordFault();
+            if (breaksSharing)
             {
-                auto process = block.process.lock();
-                if (process && process->getState() != Process::WAITING &&
-                    process->getCreationTime() < oldestTime)
-                {
-                    oldestProcess = process;
-                    oldestTime = process->getCreationTime();
-                    oldestPID = process->getPID();
-                    memToFree = block.size;
-                }
+                cowFaults.fetch_add(1, std::memory_order_relaxed);
             }
         }
+        return false;
     }
 
-    if (oldestProcess)
+    // The frame stays mapped while the shard is locked, so its bits are ours
+    touchFrame(frame, isWrite);
+    if (core)
     {
-        if (oldestProcess->getState() != Process::FINISHED)
-        {
-            oldestProcess->setState(Process::READY);
-        }
+        std::lock_guard<std::mutex> tlbLock(core->mutex);
+        core->tlb.insert(static_cast<uint32_t>(pid), static_cast<uint32_t>(pageNumber), frame,
+                         !frameTable.test(frame, FrameTable::SHARED));
+    }
+    return true;
+}
 
-        if (usePageBasedAllocation)
-        {
-            auto it = processPages.find(oldestPID);
-            if (it != processPages.end())
-            {
-                pagesPagedOut += numPages;
-                if (usedMemory >= memToFree)
-                {
-                    usedMemory -= memToFree;
-                }
+void MemoryManager::touchFrame(uint32_t frame, bool isWrite)
+{
+    replacementPolicy->recordReference();
 
-                for (uint32_t frame : it->second)
-                {
-                    pageTable[frame].isPresent = false;
-                    pageTable[frame].process.reset();
-                }
-                processPages.erase(it);
-            }
-        }
-        else
-        {
-            deallocateMemory(oldestProcess);
-        }
-        return true;
+    frameTable.set(frame, FrameTable::REFERENCED);
+    frameTable.set(frame, FrameTable::IN_WORKING_SET);
+    frameTable.setLastAccess(frame, accessClock.fetch_add(1, std::memory_order_relaxed) + 1);
+    if (isWrite)
+    {
+        frameTable.set(frame, FrameTable::DIRTY);
     }
+    if (frameTable.testAndClear(frame, FrameTable::PREFETCHED))
+    {
+        prefetchHits.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-    return false;
+// Caller holds the process's shard mutex, so no core can refill the entry
+void MemoryManager::shootdown(int pid, uint32_t pageNumber)
+{
+    for (auto &core : coreTLBs)
+    {
+        std::lock_guard<std::mutex> tlbLock(core->mutex);
+        core->tlb.invalidate(static_cast<uint32_t>(pid), pageNumber);
+    }
 }
 
-size_t MemoryManager::getUsedMemory() const
+void MemoryManager::sampleWorkingSets()
 {
-    std::lock_guard<std::mutex> lock(memoryMutex);
+    if (!initialized || !usePageBasedAllocation)
+        return;
 
-    size_t activeMemory = 0;
-    if (usePageBasedAllocation)
+    // Clock policies consume REFERENCED, so sampling keeps its own bit
+    size_t demand = sharedFrames.load(std::memory_order_relaxed);
+    for (auto &shard : pageTableShards)
     {
-        for (const auto &pair : processPages)
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto &pair : shard->processes)
         {
-            auto proc = pageTable[pair.second[0]].process.lock();
-            if (proc && (proc->getState() == Process::RUNNING || proc->getState() == Process::READY))
+            ProcessPageTable &entry = pair.second;
+            size_t workingSet = entry.evictedReferenced;
+            if (entry.frameFactor > 1)
             {
-                activeMemory += proc->getMemoryRequirement() * 1024;
+                // Huge pages are pinned, so all of them count
+                workingSet = entry.frames.size() * entry.frameFactor;
             }
-        }
-    }
-    else
-    {
-        for (const auto &block : memoryBlocks)
-        {
-            if (!block.process.expired() && !block.isFree)
+            else
             {
-                auto proc = block.process.lock();
-                if (proc && (proc->getState() == Process::RUNNING || proc->getState() == Process::READY))
+                for (uint32_t frame : entry.frames)
                 {
-                    activeMemory += block.size;
+                    if (frame != INVALID_FRAME && !frameTable.test(frame, FrameTable::SHARED) &&
+                        frameTable.testAndClear(frame, FrameTable::IN_WORKING_SET))
+                    {
+                        ++workingSet;
+                    }
                 }
             }
+
+            entry.workingSet = workingSet;
+            entry.evictedReferenced = 0;
+            demand += workingSet;
+        }
+    }
+
+    workingSetDemand.store(demand, std::memory_order_relaxed);
+}
+
+size_t MemoryManager::getWorkingSet(int pid)
+{
+    if (!initialized || !usePageBasedAllocation)
+        return 0;
+
+    PageTableShard &shard = getShard(pid);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.processes.find(pid);
+    return it != shard.processes.end() ? it->second.workingSet : 0;
+}
+
+void MemoryManager::switchContext(int coreID, int pid)
+{
+    if (coreID < 0 || static_cast<size_t>(coreID) >= coreTLBs.size())
+        return;
+
+    uint32_t frameFactor = 1;
+    if (usePageBasedAllocation)
+    {
+        PageTableShard &shard = getShard(pid);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.processes.find(pid);
+        if (it != shard.processes.end())
+        {
+            frameFactor = it->second.frameFactor;
         }
     }
-    return activeMemory;
+
+    CoreTLB &core = *coreTLBs[coreID];
+    std::lock_guard<std::mutex> tlbLock(core.mutex);
+    core.tlb.switchTo(static_cast<uint32_t>(pid));
+    core.pid = pid;
+    core.frameFactor = frameFactor;
+}
+
+uint32_t MemoryManager::takeTranslationPenalty(int coreID)
+{
+    if (coreID < 0 || static_cast<size_t>(coreID) >= coreTLBs.size())
+        return 0;
+
+    return coreTLBs[coreID]->pendingPenalty.exchange(0, std::memory_order_relaxed);
+}
+
+void MemoryManager::prefetch(int pid, size_t startAddress, size_t endAddress, bool isWrite)
+{
+    if (!initialized || !usePageBasedAllocation)
+        return;
+
+    PageTableShard &shard = getShard(pid);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Huge pages are always resident
+    auto it = shard.processes.find(pid);
+    if (it == shard.processes.end() || it->second.frames.empty() || it->second.frameFactor > 1)
+        return;
+
+    size_t lastPage = std::min(endAddress / pageSize, it->second.frames.size() - 1);
+    for (size_t page = startAddress / pageSize; page <= lastPage; ++page)
+    {
+        uint32_t frame = it->second.frames[page];
+        bool needed = frame == INVALID_FRAME || (isWrite && frameTable.test(frame, FrameTable::SHARED));
+        if (needed && submitPageIn(pid, static_cast<uint32_t>(page), true, isWrite))
+        {
+            prefetchRequests.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool MemoryManager::submitPageIn(int pid, uint32_t pageNumber, bool isPrefetch, bool isWrite)
+{
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+
+        // Already queued or in flight
+        if (!pendingPageIns.insert(std::make_pair(pid, pageNumber)).second)
+            return false;
+
+        ioQueue.push_back({pid, pageNumber, isPrefetch, isWrite});
+    }
+    ioCv.notify_one();
+    return true;
+}
+
+void MemoryManager::finishPageIn(int pid, uint32_t pageNumber)
+{
+    std::lock_guard<std::mutex> lock(ioMutex);
+    pendingPageIns.erase(std::make_pair(pid, pageNumber));
+}
+
+void MemoryManager::ioLoop()
+{
+    std::unique_lock<std::mutex> lock(ioMutex);
+
+    while (ioRunning)
+    {
+        ioCv.wait(lock, [this]
+                  { return !ioRunning || !ioQueue.empty(); });
+
+        if (!ioRunning)
+            break;
+
+        IORequest request = ioQueue.front();
+        ioQueue.pop_front();
+
+        lock.unlock();
+        servicePageIn(request);
+        lock.lock();
+    }
+}
+
+void MemoryManager::drainPageIns()
+{
+    std::unique_lock<std::mutex> lock(ioMutex);
+    while (!ioQueue.empty())
+    {
+        IORequest request = ioQueue.front();
+        ioQueue.pop_front();
+
+        lock.unlock();
+        servicePageIn(request);
+        lock.lock();
+    }
+}
+
+void MemoryManager::servicePageIn(const IORequest &request)
+{
+    PageTableShard &shard = getShard(request.pid);
+
+    uint32_t readSlot;
+    uint32_t sharedFrame = INVALID_FRAME; // Copy source when breaking sharing
+    bool isText;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.processes.find(request.pid);
+        if (it == shard.processes.end())
+        {
+            finishPageIn(request.pid, request.pageNumber);
+            return;
+        }
+
+        ProcessPageTable &entry = it->second;
+        uint32_t current = entry.frames[request.pageNumber];
+        if (current != INVALID_FRAME)
+        {
+            if (!request.isWrite || !frameTable.test(current, FrameTable::SHARED))
+            {
+                finishPageIn(request.pid, request.pageNumber);
+                return;
+            }
+            sharedFrame = current;
+        }
+
+        isText = current == INVALID_FRAME && request.pageNumber < entry.imageIDs.size();
+        if (isText && mapImagePage(entry, request.pageNumber))
+        {
+            finishPageIn(request.pid, request.pageNumber);
+            return;
+        }
+        readSlot = entry.swapSlots[request.pageNumber];
+    }
+
+    // Pick a free frame from this process's shard or evict one. Only when
+    // nothing is evictable is a free huge frame carved into base frames, and
+    // then a text frame reclaimed. Text past its limit always takes the
+    // frame of other text.
+    uint32_t frame;
+    uint32_t writeSlot = SwapStore::INVALID_SLOT;
+    std::vector<uint32_t> freeFrame;
+    bool found;
+    if (isText && imageFramesFull())
+    {
+        found = reclaimImageFrame(frame);
+    }
+    else if (framePool.take(static_cast<size_t>(request.pid), 1, freeFrame))
+    {
+        found = true;
+    }
+    else
+    {
+        found = evictVictim(frame, writeSlot) ||
+                (carveHugeFrame() && framePool.take(static_cast<size_t>(request.pid), 1, freeFrame)) ||
+                reclaimImageFrame(frame);
+    }
+
+    if (!found)
+    {
+        finishPageIn(request.pid, request.pageNumber);
+        return;
+    }
+    if (!freeFrame.empty())
+    {
+        frame = freeFrame.front();
+    }
+
+    reserveFrame(frame, request.pid, request.pageNumber);
+
+    // The frame is in transit and the shared source stays pinned by this
+    // process's mapping, so nothing else touches either while unlocked
+    if (writeSlot != SwapStore::INVALID_SLOT)
+    {
+        swapStore.writeSlot(writeSlot, getFrameData(frame));
+    }
+    if (sharedFrame != INVALID_FRAME)
+    {
+        std::memcpy(getFrameData(frame), getFrameData(sharedFrame), pageSize);
+    }
+    else if (!compressedPool.load(pageKey(request.pid, request.pageNumber), getFrameData(frame)))
+    {
+        if (readSlot != SwapStore::INVALID_SLOT)
+        {
+            swapStore.readSlot(readSlot, getFrameData(frame));
+        }
+        else
+        {
+            std::memset(getFrameData(frame), 0, pageSize);
+        }
+    }
+
+    writebackCompressed();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    finishPageIn(request.pid, request.pageNumber);
+
+    // The process may have finished, or a text page been shared, while the
+    // transfer was running
+    auto it = shard.processes.find(request.pid);
+    if (it == shard.processes.end() || it->second.frames[request.pageNumber] != sharedFrame)
+    {
+        discardFrame(frame);
+        return;
+    }
+
+    if (isText)
+    {
+        installImagePage(frame, it->second, request.pageNumber);
+        return;
+    }
+
+    if (sharedFrame != INVALID_FRAME)
+    {
+        shootdown(request.pid, request.pageNumber);
+        unmapShared(sharedFrame);
+    }
+
+    // The page is written again when evicted
+    uint32_t &slot = it->second.swapSlots[request.pageNumber];
+    swapStore.freeSlot(slot);
+    slot = SwapStore::INVALID_SLOT;
+
+    std::lock_guard<std::mutex> policyLock(policyMutex);
+    mapFrame(frame, it->second);
+    if (request.isPrefetch)
+    {
+        frameTable.set(frame, FrameTable::PREFETCHED);
+    }
+}
+
+bool MemoryManager::evictVictim(uint32_t &frame, uint32_t &writeSlot)
+{
+    // The victim is chosen under policyMutex alone, then confirmed under its
+    // owner's shard lock; a frame freed or remapped in between is skipped
+    for (size_t attempt = 0; attempt < frameTable.size(); ++attempt)
+    {
+        uint32_t victim;
+        {
+            std::lock_guard<std::mutex> policyLock(policyMutex);
+            if (!replacementPolicy->selectVictim(frameTable, victim))
+                return false;
+        }
+
+        uint32_t ownerPID = frameTable.getOwner(victim);
+        uint32_t pageNumber = frameTable.getPageNumber(victim);
+        if (ownerPID == FrameTable::NO_OWNER)
+            continue;
+
+        PageTableShard &shard = getShard(static_cast<int>(ownerPID));
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.processes.find(static_cast<int>(ownerPID));
+        if (it == shard.processes.end() || pageNumber >= it->second.frames.size() ||
+            it->second.frames[pageNumber] != victim)
+            continue;
+
+        // A resident page has no backing copy, so it needs a slot, even if it
+        // ends up in the compressed pool, so its writeback always has
+        // somewhere to go. Admission control keeps a slot free for it; should
+        // none be, the page is kept and moved to the back of the policy's
+        // order, and if no victim can be written the fault is retried once a
+        // process frees its slots.
+        uint32_t &slot = it->second.swapSlots[pageNumber];
+        if (slot == SwapStore::INVALID_SLOT && !swapStore.allocateSlot(slot))
+        {
+            std::lock_guard<std::mutex> policyLock(policyMutex);
+            replacementPolicy->onFrameLoaded(victim);
+            continue;
+        }
+
+        it->second.frames[pageNumber] = INVALID_FRAME;
+        shootdown(static_cast<int>(ownerPID), pageNumber);
+        if (frameTable.test(victim, FrameTable::IN_WORKING_SET))
+        {
+            it->second.evictedReferenced++;
+        }
+
+        // The page is compressed into the pool, which is read before the
+        // slot on a fault, or written to its slot if it does not compress
+        writeSlot = SwapStore::INVALID_SLOT;
+        if (!compressedPool.store(pageKey(static_cast<int>(ownerPID), pageNumber), getFrameData(victim)))
+        {
+            writeSlot = slot;
+        }
+
+        // The frame is handed straight to the incoming page, not the pool
+        replacementPolicy->recordEviction();
+        {
+            std::lock_guard<std::mutex> policyLock(policyMutex);
+            clearFrame(victim);
+        }
+        pagesPagedOut.fetch_add(1, std::memory_order_relaxed);
+
+        frame = victim;
+        return true;
+    }
+
+    return false;
+}
+
+void MemoryManager::writebackCompressed()
+{
+    // Only the I/O thread moves pages between the pool and swap, so a page
+    // is never faulted in while its writeback is under way
+    std::vector<char> page(pageSize);
+    uint64_t key;
+    while (compressedPool.evictOldest(key, page.data()))
+    {
+        int pid = static_cast<int>(key >> 32);
+        uint32_t pageNumber = static_cast<uint32_t>(key);
+
+        PageTableShard &shard = getShard(pid);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.processes.find(pid);
+        if (it == shard.processes.end())
+            continue;
+
+        // Pooled pages were given their slot when they were evicted
+        uint32_t slot = it->second.swapSlots[pageNumber];
+        if (slot != SwapStore::INVALID_SLOT)
+        {
+            swapStore.writeSlot(slot, page.data());
+        }
+    }
+}
+
+void MemoryManager::reserveFrame(uint32_t frame, int pid, uint32_t pageNumber)
+{
+    frameTable.assign(frame, FrameTable::PRESENT | FrameTable::IN_TRANSIT, static_cast<uint32_t>(pid), pageNumber);
+    usedMemory.fetch_add(pageSize, std::memory_order_relaxed);
+}
+
+// Caller holds the owner's shard mutex and policyMutex
+void MemoryManager::mapFrame(uint32_t frame, ProcessPageTable &owner)
+{
+    frameTable.setFlags(frame, FrameTable::PRESENT | FrameTable::REFERENCED | FrameTable::IN_WORKING_SET);
+    frameTable.setLastAccess(frame, accessClock.fetch_add(1, std::memory_order_relaxed) + 1);
+
+    owner.frames[frameTable.getPageNumber(frame)] = frame;
+    replacementPolicy->onFrameLoaded(frame);
+    activeMemory.fetch_add(pageSize, std::memory_order_relaxed);
+    pagesPagedIn.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Caller holds policyMutex
+void MemoryManager::releaseFrame(uint32_t frame)
+{
+    clearFrame(frame);
+    framePool.release(frame);
+}
+
+// Caller holds policyMutex
+void MemoryManager::clearFrame(uint32_t frame)
+{
+    replacementPolicy->onFrameFreed(frame);
+    if (!frameTable.test(frame, FrameTable::IN_TRANSIT))
+    {
+        activeMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+    }
+
+    frameTable.reset(frame);
+    usedMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+}
+
+// Returns a reserved frame that was never mapped, so no policy knows it
+void MemoryManager::discardFrame(uint32_t frame)
+{
+    frameTable.reset(frame);
+    usedMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+    framePool.release(frame);
+}
+
+uint32_t MemoryManager::acquireImage(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(imageMutex);
+
+    auto it = textImageIDs.find(key);
+    if (it != textImageIDs.end())
+        return it->second;
+
+    uint32_t imageID = static_cast<uint32_t>(textImages.size());
+    textImages.push_back({key, INVALID_FRAME});
+    textImageIDs[key] = imageID;
+    return imageID;
+}
+
+// Caller holds the owner's shard mutex
+bool MemoryManager::mapImagePage(ProcessPageTable &owner, uint32_t pageNumber)
+{
+    std::lock_guard<std::mutex> lock(imageMutex);
+
+    const TextImage &image = textImages[owner.imageIDs[pageNumber]];
+    if (image.frame == INVALID_FRAME)
+        return false;
+
+    mapShared(image.frame, owner, pageNumber);
+    return true;
+}
+
+// Caller holds the owner's shard mutex. The freshly loaded frame becomes the
+// image's copy of the page unless another process installed one first.
+void MemoryManager::installImagePage(uint32_t frame, ProcessPageTable &owner, uint32_t pageNumber)
+{
+    std::lock_guard<std::mutex> lock(imageMutex);
+
+    uint32_t imageID = owner.imageIDs[pageNumber];
+    TextImage &image = textImages[imageID];
+    if (image.frame != INVALID_FRAME)
+    {
+        discardFrame(frame);
+    }
+    else
+    {
+        frameTable.assign(frame, FrameTable::PRESENT | FrameTable::SHARED, imageID, 0);
+        image.frame = frame;
+        activeMemory.fetch_add(pageSize, std::memory_order_relaxed);
+        sharedFrames.fetch_add(1, std::memory_order_relaxed);
+        pagesPagedIn.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    mapShared(image.frame, owner, pageNumber);
+}
+
+// Image frames are mapped under imageMutex so they cannot be freed meanwhile;
+// the zero frame is never freed
+void MemoryManager::mapShared(uint32_t frame, ProcessPageTable &owner, uint32_t pageNumber)
+{
+    frameTable.addRef(frame);
+    owner.frames[pageNumber] = frame;
+    sharedMappings.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryManager::unmapShared(uint32_t frame)
+{
+    sharedMappings.fetch_sub(1, std::memory_order_relaxed);
+    if (frame == zeroFrame)
+    {
+        frameTable.dropRef(frame);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(imageMutex);
+    if (frameTable.dropRef(frame) > 0)
+        return;
+
+    // Last mapping gone: the image page is unloaded and its frame freed
+    textImages[frameTable.getOwner(frame)].frame = INVALID_FRAME;
+    frameTable.reset(frame);
+    activeMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+    usedMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+    sharedFrames.fetch_sub(1, std::memory_order_relaxed);
+    framePool.release(frame);
+}
+
+bool MemoryManager::canCommit(size_t bytes) const
+{
+    if (!usePageBasedAllocation || pageSize == 0)
+        return true;
+
+    size_t pages = (bytes + pageSize - 1) / pageSize;
+    return committedPages.load(std::memory_order_relaxed) + pages <= commitLimit;
+}
+
+// Zero frame aside, every shared frame holds text
+bool MemoryManager::imageFramesFull() const
+{
+    size_t textFrames = sharedFrames.load(std::memory_order_relaxed) - (zeroFrame != INVALID_FRAME ? 1 : 0);
+    return textFrames >= imageFrameLimit;
+}
+
+// Takes a text frame away from every process mapping it, for the caller to
+// reserve; the page is loaded again on its next fault. Text is never
+// written, so nothing is saved. The frame is dropped from its image first,
+// so no new mapping can appear while the shards are scanned, and an extra
+// reference keeps unmapShared from freeing it meanwhile.
+bool MemoryManager::reclaimImageFrame(uint32_t &frame)
+{
+    uint32_t victim = INVALID_FRAME;
+    {
+        std::lock_guard<std::mutex> lock(imageMutex);
+        for (uint32_t i = 0; i < hugeRegionStart && victim == INVALID_FRAME; ++i)
+        {
+            uint32_t candidate = (imageReclaimHand + i) % hugeRegionStart;
+            if (candidate != zeroFrame && frameTable.test(candidate, FrameTable::SHARED))
+            {
+                victim = candidate;
+            }
+        }
+        if (victim == INVALID_FRAME)
+            return false;
+
+        imageReclaimHand = (victim + 1) % hugeRegionStart;
+        textImages[frameTable.getOwner(victim)].frame = INVALID_FRAME;
+        frameTable.addRef(victim);
+    }
+
+    for (auto &shard : pageTableShards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto &pair : shard->processes)
+        {
+            ProcessPageTable &entry = pair.second;
+            for (uint32_t page = 0; page < entry.imageIDs.size(); ++page)
+            {
+                if (entry.frames[page] == victim)
+                {
+                    entry.frames[page] = INVALID_FRAME;
+                    shootdown(pair.first, page);
+                    frameTable.dropRef(victim);
+                    sharedMappings.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    frameTable.reset(victim);
+    activeMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+    usedMemory.fetch_sub(pageSize, std::memory_order_relaxed);
+    sharedFrames.fetch_sub(1, std::memory_order_relaxed);
+    imageReclaims.fetch_add(1, std::memory_order_relaxed);
+    frame = victim;
+    return true;
+}
+
+void MemoryManager::deallocateMemory(std::shared_ptr<Process> process)
+{
+    if (!process)
+        return;
+
+    if (usePageBasedAllocation)
+    {
+        PageTableShard &shard = getShard(process->getPID());
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.processes.find(process->getPID());
+        if (it != shard.processes.end() && it->second.frameFactor > 1)
+        {
+            releaseHuge(it->second);
+            shard.processes.erase(it);
+        }
+        else if (it != shard.processes.end())
+        {
+            for (uint32_t &frame : it->second.frames)
+            {
+                if (frame != INVALID_FRAME && frameTable.test(frame, FrameTable::SHARED))
+                {
+                    unmapShared(frame);
+                    frame = INVALID_FRAME;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> policyLock(policyMutex);
+                for (uint32_t frame : it->second.frames)
+                {
+                    if (frame != INVALID_FRAME)
+                    {
+                        releaseFrame(frame);
+                    }
+                }
+            }
+            for (size_t page = 0; page < it->second.swapSlots.size(); ++page)
+            {
+                swapStore.freeSlot(it->second.swapSlots[page]);
+                compressedPool.erase(pageKey(process->getPID(), static_cast<uint32_t>(page)));
+            }
+            committedPages.fetch_sub(it->second.committedPages, std::memory_order_relaxed);
+            shard.processes.erase(it);
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+
+        auto it = flatAllocations.find(process->getPID());
+        if (it != flatAllocations.end())
+        {
+            flatAllocator->release(it->second.address);
+            usedMemory -= it->second.size;
+            requestedMemory -= it->second.requested;
+            flatAllocations.erase(it);
+        }
+    }
+}
+
+size_t MemoryManager::getUsedMemory() const
+{
+    // Paged mode counts only mapped pages; frames still in transit are excluded
+    return usePageBasedAllocation ? activeMemory.load(std::memory_order_relaxed)
+                                  : usedMemory.load(std::memory_order_relaxed);
+}
+
+// The policy is fixed after initialize and its counters are atomic, so the
+// statistics getters below take no lock
+std::string MemoryManager::getReplacementPolicyName() const
+{
+    return replacementPolicy ? replacementPolicy->getName() : "none";
+}
+
+uint64_t MemoryManager::getPageReferences() const
+{
+    return replacementPolicy ? replacementPolicy->getReferences() : 0;
+}
+
+uint64_t MemoryManager::getPageFaults() const
+{
+    return replacementPolicy ? replacementPolicy->getFaults() : 0;
+}
+
+uint64_t MemoryManager::getPageEvictions() const
+{
+    return replacementPolicy ? replacementPolicy->getEvictions() : 0;
+}
+
+SwapStats MemoryManager::getSwapStats() const
+{
+    SwapStats stats;
+    stats.totalSlots = swapStore.getNumSlots();
+    stats.usedSlots = swapStore.isOpen() ? swapStore.getUsedSlots() : 0;
+    stats.reads = swapStore.getReads();
+    stats.writes = swapStore.getWrites();
+    stats.fullFailures = swapStore.getFullFailures();
+    stats.readP50 = swapStore.getReadLatency().getPercentile(50);
+    stats.readP99 = swapStore.getReadLatency().getPercentile(99);
+    stats.writeP50 = swapStore.getWriteLatency().getPercentile(50);
+    stats.writeP99 = swapStore.getWriteLatency().getPercentile(99);
+    return stats;
+}
+
+CompressedPoolStats MemoryManager::getCompressedPoolStats() const
+{
+    CompressedPoolStats stats;
+    stats.capacity = compressedPool.getCapacity();
+    stats.usedBytes = compressedPool.getUsedBytes();
+    stats.storedPages = compressedPool.getStoredPages();
+    stats.ratio = stats.usedBytes ? static_cast<double>(stats.storedPages * pageSize) / stats.usedBytes : 0.0;
+    stats.stores = compressedPool.getStores();
+    stats.rejects = compressedPool.getRejects();
+    stats.hits = compressedPool.getHits();
+    stats.writebacks = compressedPool.getWritebacks();
+    return stats;
+}
+
+std::vector<TLBStats> MemoryManager::getTLBStats() const
+{
+    std::vector<TLBStats> stats;
+    for (const auto &core : coreTLBs)
+    {
+        stats.push_back({core->tlb.getHits(), core->tlb.getMisses(), core->tlb.getShootdowns(),
+                         core->tlb.getSwitches(), core->penaltyCycles.load(std::memory_order_relaxed)});
+    }
+    return stats;
+}
+
+SharingStats MemoryManager::getSharingStats() const
+{
+    SharingStats stats;
+    {
+        std::lock_guard<std::mutex> lock(imageMutex);
+        stats.textImages = textImages.size();
+    }
+    stats.sharedFrames = sharedFrames.load(std::memory_order_relaxed);
+    stats.sharedMappings = sharedMappings.load(std::memory_order_relaxed);
+    size_t residentFrames = pageSize ? activeMemory.load(std::memory_order_relaxed) / pageSize : 0;
+    stats.privateFrames = residentFrames > stats.sharedFrames ? residentFrames - stats.sharedFrames : 0;
+    stats.cowFaults = cowFaults.load(std::memory_order_relaxed);
+    stats.textReclaims = imageReclaims.load(std::memory_order_relaxed);
+    return stats;
+}
+
+HugeFrameStats MemoryManager::getHugeFrameStats() const
+{
+    HugeFrameStats stats;
+    stats.frameSize = hugeFrameFactor > 1 ? getHugeFrameSize() : 0;
+    stats.totalFrames = hugeFrames.load(std::memory_order_relaxed);
+    stats.freeFrames = hugeFramePool.getFreeFrames();
+    stats.mappings = hugeMappings.load(std::memory_order_relaxed);
+    stats.carves = hugeCarves.load(std::memory_order_relaxed);
+    stats.reassemblies = hugeReassemblies.load(std::memory_order_relaxed);
+    stats.fallbacks = hugeFallbacks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool MemoryManager::compactMemory(size_t &bytesMoved)
+{
+    std::lock_guard<std::mutex> lock(memoryMutex);
+
+    if (usePageBasedAllocation || !flatAllocator || !flatAllocator->canCompact())
+        return false;
+
+    bytesMoved = compactFlat();
+    return true;
+}
+
+size_t MemoryManager::compactFlat()
+{
+    std::vector<std::pair<size_t, size_t>> relocations;
+    size_t moved = flatAllocator->compact(relocations);
+
+    if (!relocations.empty())
+    {
+        std::unordered_map<size_t, FlatAllocation *> byAddress;
+        for (auto &pair : flatAllocations)
+        {
+            byAddress[pair.second.address] = &pair.second;
+        }
+        for (const auto &relocation : relocations)
+        {
+            auto it = byAddress.find(relocation.first);
+            if (it != byAddress.end())
+            {
+                it->second->address = relocation.second;
+            }
+        }
+    }
+
+    compactions++;
+    compactedBytes += moved;
+    return moved;
+}
+
+double MemoryManager::getExternalFragmentation() const
+{
+    // Share of free memory that lies outside the largest free block
+    size_t freeBytes = totalMemory - usedMemory;
+    if (freeBytes == 0)
+        return 0.0;
+
+    return (freeBytes - flatAllocator->getLargestFreeBlock()) * 100.0 / freeBytes;
+}
+
+FlatStats MemoryManager::getFlatStats() const
+{
+    std::lock_guard<std::mutex> lock(memoryMutex);
+
+    FlatStats stats;
+    stats.allocator = flatAllocator ? flatAllocator->getName() : "none";
+    stats.liveBlocks = flatAllocations.size();
+    stats.freeBlocks = flatAllocator ? flatAllocator->getFreeBlockCount() : 0;
+    stats.largestFreeBlock = flatAllocator ? flatAllocator->getLargestFreeBlock() : 0;
+    stats.internalFragmentation = usedMemory - requestedMemory;
+    stats.externalFragmentation = flatAllocator ? getExternalFragmentation() : 0.0;
+    stats.compactions = compactions;
+    stats.autoCompactions = autoCompactions;
+    stats.compactedBytes = compactedBytes;
+    stats.swapOuts = flatSwapOuts;
+    return stats;
 }
\ No newline at end of file
@@ -3,26 +3,152 @@
 
 #include <cstdint>
 #include <vector>
-#include <map>
+#include <unordered_map>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <string>
+#include <set>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <fstream>
 #include "Config.h"
+#include "FrameTable.h"
+#include "FramePool.h"
+#include "IReplacementPolicy.h"
+#include "IFlatAllocator.h"
+#include "SwapStore.h"
+#include "CompressedPool.h"
+#include "TLB.h"
+#include "MemorySnapshot.h"
 
 class Process;
 
-struct MemoryBlock
+// Block reserved for a process in flat mode
+struct FlatAllocation
 {
-    size_t startAddress;
-    size_t size;
-    bool isFree;
-    std::weak_ptr<Process> process; // Owner process
+    size_t address;
+    size_t size;      // Bytes reserved by the allocator
+    size_t requested; // Bytes the process asked for
+    std::weak_ptr<Process> process;
 };
 
-struct Page
+
+// Per-process mapping from virtual page to frame
+struct ProcessPageTable
 {
-    uint32_t frameNumber;
-    bool isPresent;
-    std::weak_ptr<Process> process;
+    std::vector<uint32_t> frames;    // INVALID_FRAME while the page is paged out
+    std::vector<uint32_t> swapSlots; // Backing store copy while paged out, INVALID_SLOT if none
+    std::vector<uint32_t> imageIDs;  // Text image of each leading text page
+    uint32_t frameFactor;            // Base frames per page, above 1 for huge pages
+    size_t workingSet;               // Private pages referenced in the last sample window
+    size_t evictedReferenced;        // Pages evicted this window after being referenced
+    size_t committedPages;           // Pages that may need a private frame or slot
+};
+
+// One page of program text, shared by every process whose text has the
+// same contents in some page
+struct TextImage
+{
+    std::string key;
+    uint32_t frame; // INVALID_FRAME until some process loads the page
+};
+
+struct SwapStats
+{
+    size_t totalSlots;
+    size_t usedSlots;
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t fullFailures;
+    uint64_t readP50;
+    uint64_t readP99;
+    uint64_t writeP50;
+    uint64_t writeP99;
+};
+
+struct CompressedPoolStats
+{
+    size_t capacity;     // Bytes, 0 when the pool is disabled
+    size_t usedBytes;
+    size_t storedPages;
+    double ratio;        // Uncompressed over compressed size of the stored pages
+    uint64_t stores;
+    uint64_t rejects;    // Pages that did not compress well enough
+    uint64_t hits;       // Faults served from the pool
+    uint64_t writebacks; // Pages pushed out to swap when the pool was full
+};
+
+struct SharingStats
+{
+    size_t textImages;      // Distinct text pages seen
+    size_t sharedFrames;    // Resident frames mapped read-only, including the zero frame
+    uint64_t sharedMappings; // Page table entries pointing at shared frames
+    size_t privateFrames;
+    uint64_t cowFaults;
+    uint64_t textReclaims;  // Text frames taken back from the processes mapping them
+};
+
+struct HugeFrameStats
+{
+    size_t frameSize;  // Bytes, 0 when huge frames are disabled
+    size_t totalFrames; // Huge frames left in the region
+    size_t freeFrames;
+    size_t mappings;   // Huge pages mapped by running processes
+    uint64_t carves;   // Free huge frames split into base frames
+    uint64_t reassemblies; // Carved huge frames rebuilt once their base frames were free
+    uint64_t fallbacks; // Eligible processes admitted with base pages
+};
+
+struct FlatStats
+{
+    std::string allocator;
+    size_t liveBlocks;
+    size_t freeBlocks;
+    size_t largestFreeBlock;
+    size_t internalFragmentation; // Reserved bytes beyond what processes requested
+    double externalFragmentation; // Percent of free memory outside the largest free block
+    uint64_t compactions;
+    uint64_t autoCompactions;
+    uint64_t compactedBytes;
+    uint64_t swapOuts; // Processes whose block was taken for a new process
+};
+
+// Page tables of the processes whose PID maps to this shard
+struct PageTableShard
+{
+    std::mutex mutex;
+    std::unordered_map<int, ProcessPageTable> processes;
+};
+
+// Translation cache of one core, locked by that core and by shootdowns
+struct CoreTLB
+{
+    std::mutex mutex;
+    TLB tlb;
+    std::atomic<uint32_t> pendingPenalty{0}; // Miss cycles not yet charged to the core
+    std::atomic<uint64_t> penaltyCycles{0};
+    int pid = -1;             // Process the core switched to last
+    uint32_t frameFactor = 1; // Its page size in base frames, which sets the TLB page numbers
+};
+
+struct TLBStats
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t shootdowns;
+    uint64_t switches;
+    uint64_t penaltyCycles;
+};
+
+// Page-in submitted to the I/O thread
+struct IORequest
+{
+    int pid;
+    uint32_t pageNumber;
+    bool isPrefetch;
+    bool isWrite; // Breaks copy-on-write if the page is mapped shared
 };
 
 class MemoryManager
@@ -34,6 +160,8 @@ public:
         return instance;
     }
 
+    static const uint32_t INVALID_FRAME = UINT32_MAX;
+
     // Initialize memory system
     void initialize();
 
@@ -41,47 +169,231 @@ public:
     bool allocateMemory(std::shared_ptr<Process> process);
     void deallocateMemory(std::shared_ptr<Process> process);
 
+    // Slides live flat blocks together; false if the allocator cannot relocate
+    bool compactMemory(size_t &bytesMoved);
+
+    void shutdown();
+
+    // Page reference from a running process, translated through the core's
+    // TLB when coreID is given. Returns false when the page is not resident;
+    // a page-in is queued and the caller retries next cycle.
+    bool accessMemory(int pid, size_t virtualAddress, bool isWrite, int coreID = -1);
+
+    // Context switch on a core; TLB entries are tagged by PID and survive it
+    void switchContext(int coreID, int pid);
+
+    // Returns and clears the TLB miss cycles the core still owes
+    uint32_t takeTranslationPenalty(int coreID);
+
+    // Working set estimation, sampled once per working-set-window cycles.
+    // Demand is the private working sets plus the pinned shared frames.
+    void sampleWorkingSets();
+    size_t getWorkingSet(int pid);
+    size_t getWorkingSetDemand() const { return workingSetDemand.load(std::memory_order_relaxed); }
+    size_t getFrameCapacity() const { return frameTable.size(); }
+    bool isOvercommitted() const { return usePageBasedAllocation && getWorkingSetDemand() > getFrameCapacity(); }
+
+    // Whether a process of the given size could be admitted now without
+    // its pages outgrowing the private frames and swap slots left
+    bool canCommit(size_t bytes) const;
+
+    // Queue page-ins for the non-resident pages of an address range; with
+    // isWrite, shared pages in the range get their private copies early
+    void prefetch(int pid, size_t startAddress, size_t endAddress, bool isWrite = false);
+
+    // A single-threaded scheduler has no I/O thread; it calls this at the
+    // end of each cycle to service queued page-ins in submission order
+    void drainPageIns();
+
     // Memory status
     size_t getTotalMemory() const { return totalMemory; }
     size_t getUsedMemory() const;
-    size_t getFreeMemory() const { return totalMemory - usedMemory; }
+    size_t getFreeMemory() const { return totalMemory - usedMemory.load(std::memory_order_relaxed); }
     bool isPageBasedAllocation() const { return usePageBasedAllocation; }
 
     // Memory statistics for vmstat
-    uint64_t getPagesPagedIn() const { return pagesPagedIn; }
-    uint64_t getPagesPagedOut() const { return pagesPagedOut; }
+    uint64_t getPagesPagedIn() const { return pagesPagedIn.load(std::memory_order_relaxed); }
+    uint64_t getPagesPagedOut() const { return pagesPagedOut.load(std::memory_order_relaxed); }
+    std::string getReplacementPolicyName() const;
+    uint64_t getPageReferences() const;
+    uint64_t getPageFaults() const;
+    uint64_t getPageEvictions() const;
+    SwapStats getSwapStats() const;
+    CompressedPoolStats getCompressedPoolStats() const;
+    std::vector<TLBStats> getTLBStats() const;
+    SharingStats getSharingStats() const;
+    FlatStats getFlatStats() const;
+    uint64_t getFaultStalls() const { return faultStalls.load(std::memory_order_relaxed); }
+    uint64_t getPrefetchRequests() const { return prefetchRequests.load(std::memory_order_relaxed); }
+    uint64_t getPrefetchHits() const { return prefetchHits.load(std::memory_order_relaxed); }
+    size_t getFramePoolShards() const { return framePool.getShardCount(); }
+    uint64_t getFramePoolRebalances() const { return framePool.getRebalances(); }
+    HugeFrameStats getHugeFrameStats() const;
+
+    // Queues a memory-map snapshot for the snapshot thread, which captures
+    // and writes it; never waits on file I/O. When the scheduler is single
+    // threaded the snapshot is written inline so it shows exactly this cycle.
+    void requestSnapshot(uint64_t cycle);
+    uint64_t getSnapshotsWritten() const { return snapshotsWritten.load(std::memory_order_relaxed); }
+    uint64_t getSnapshotsDropped() const { return snapshotsDropped.load(std::memory_order_relaxed); }
 
     bool isInitialized() const { return initialized; }
 
 private:
-    MemoryManager() : totalMemory(0), usedMemory(0), pagesPagedIn(0), pagesPagedOut(0),
-                      usePageBasedAllocation(false), initialized(false) {}
+    MemoryManager() : totalMemory(0), usedMemory(0), activeMemory(0), requestedMemory(0),
+                      compactions(0), autoCompactions(0), compactedBytes(0), flatSwapOuts(0), usePageBasedAllocation(false), pageSize(0), initialized(false),
+                      hugeFrameFactor(1), hugeRegionStart(0), hugeFrames(0), hugeMappings(0), hugeCarves(0), hugeReassemblies(0), hugeFallbacks(0),
+                      tlbMissPenalty(0), accessClock(0), pagesPagedIn(0), pagesPagedOut(0), faultStalls(0),
+                      prefetchRequests(0), prefetchHits(0), zeroFrame(INVALID_FRAME), sharedFrames(0),
+                      sharedMappings(0), cowFaults(0), imageFrameLimit(0), imageReclaimHand(0), imageReclaims(0),
+                      workingSetDemand(0), committedPages(0), commitLimit(0), singleThreaded(false), ioRunning(false),
+                      snapshotRunning(false), snapshotsWritten(0), snapshotsDropped(0) {}
+    ~MemoryManager() { shutdown(); }
 
     // Memory configuration
     size_t totalMemory;
-    size_t usedMemory;
+    std::atomic<size_t> usedMemory;   // Allocated blocks, or reserved frames in paged mode
+    std::atomic<size_t> activeMemory; // Frames mapped into a process page table
+    size_t requestedMemory; // Bytes requested by flat allocations
+    uint64_t compactions;
+    uint64_t autoCompactions;
+    uint64_t compactedBytes;
+    uint64_t flatSwapOuts;
     bool usePageBasedAllocation;
     size_t pageSize;
     bool initialized;
 
     // Memory tracking
-    std::vector<MemoryBlock> memoryBlocks;             // For flat allocation
-    std::vector<Page> pageTable;                       // For paged allocation
-    std::map<int, std::vector<uint32_t>> processPages; // Process ID to page numbers
+    std::unique_ptr<IFlatAllocator> flatAllocator;     // For flat allocation
+    std::unordered_map<int, FlatAllocation> flatAllocations;
+    FrameTable frameTable;                             // For paged allocation
+    FramePool framePool;                               // Free frames, sharded
+    std::vector<std::unique_ptr<PageTableShard>> pageTableShards; // Process page tables by PID
+    std::vector<std::unique_ptr<CoreTLB>> coreTLBs;
+
+    // Huge frames come from a region at the top of memory, tracked by huge
+    // frame index. They are pinned while mapped, and a free one is split
+    // into base frames when the base pool runs dry.
+    FramePool hugeFramePool;
+    uint32_t hugeFrameFactor;
+    uint32_t hugeRegionStart; // First base frame of the region
+    std::atomic<size_t> hugeFrames;
+    std::atomic<size_t> hugeMappings;
+    std::atomic<uint64_t> hugeCarves;
+    std::atomic<uint64_t> hugeReassemblies;
+    std::mutex hugeMutex;                 // Carved huge frame list
+    std::vector<uint32_t> carvedHugeFrames; // Huge frame indices split into base frames
+    std::atomic<uint64_t> hugeFallbacks;
+    uint32_t tlbMissPenalty;
+    std::unique_ptr<IReplacementPolicy> replacementPolicy;
+    std::atomic<uint64_t> accessClock;
+
+    // Emulated physical memory and its backing store
+    std::unique_ptr<char[]> physicalMemory;
+    CompressedPool compressedPool; // Evicted pages land here before swap
+    SwapStore swapStore;
 
     // Statistics
-    uint64_t pagesPagedIn;
-    uint64_t pagesPagedOut;
+    std::atomic<uint64_t> pagesPagedIn;
+    std::atomic<uint64_t> pagesPagedOut;
+    std::atomic<uint64_t> faultStalls;
+    std::atomic<uint64_t> prefetchRequests;
+    std::atomic<uint64_t> prefetchHits;
+
+    // Copy-on-write sharing. Text pages are shared by contents and data
+    // pages start out mapped to the zero frame; both are pinned while mapped.
+    // Text may pin at most 1/IMAGE_FRAME_SHARE of the base frames, so
+    // private pages always have frames to be paged into; past that, or when
+    // nothing else can be evicted, a text frame is reclaimed from every
+    // process mapping it.
+    static const size_t IMAGE_FRAME_SHARE = 2;
+    std::vector<TextImage> textImages;
+    std::unordered_map<std::string, uint32_t> textImageIDs; // By key
+    uint32_t zeroFrame;
+    std::atomic<size_t> sharedFrames;
+    std::atomic<uint64_t> sharedMappings;
+    std::atomic<uint64_t> cowFaults;
+    size_t imageFrameLimit;
+    uint32_t imageReclaimHand; // Next frame to consider, guarded by imageMutex
+    std::atomic<uint64_t> imageReclaims;
+    std::atomic<size_t> workingSetDemand;
 
-    // Thread safety
+    // Admission control. Every private page a process may write is
+    // committed when it is admitted, and admission fails once the pages
+    // would outnumber the private frames text can never take plus the swap
+    // slots. A page's slot is freed when it is paged in, so swap only holds
+    // pages that are out and an eviction always finds a slot.
+    std::atomic<size_t> committedPages;
+    size_t commitLimit;
+
+    // Thread safety. Paged mode locks in the order page table shard, a core
+    // TLB, policyMutex or imageMutex, then ioMutex; hugeMutex is taken
+    // before the frame pools and nothing else. memoryMutex covers
+    // initialization and the flat allocator only. Counters are relaxed
+    // atomics read without locks.
     mutable std::mutex memoryMutex;
+    std::mutex policyMutex;        // Replacement policy bookkeeping
+    mutable std::mutex imageMutex; // Text images and shared frame lifetime
+    std::mutex ioMutex;            // I/O queue and pending page-ins
+
+    // Swap I/O thread, the only thread that evicts pages. Absent when the
+    // scheduler is single threaded and drains the queue itself.
+    bool singleThreaded;
+    std::thread ioThread;
+    std::condition_variable ioCv;
+    std::deque<IORequest> ioQueue;
+    std::set<std::pair<int, uint32_t>> pendingPageIns;
+    bool ioRunning;
+
+    // Snapshot writer thread; requests past the queue limit are dropped
+    static const size_t MAX_PENDING_SNAPSHOTS = 4;
+    std::thread snapshotThread;
+    std::mutex snapshotMutex;
+    std::condition_variable snapshotCv;
+    std::deque<uint64_t> snapshotRequests;
+    std::ofstream snapshotStream;
+    bool snapshotRunning;
+    std::atomic<uint64_t> snapshotsWritten;
+    std::atomic<uint64_t> snapshotsDropped;
 
     // Internal methods
     bool allocateFlat(std::shared_ptr<Process> process);
+    bool tryAllocateFlat(size_t requiredBytes, FlatAllocation &allocation);
+    bool swapOutOldestFlat();
     bool allocatePaged(std::shared_ptr<Process> process);
-    void coalesceFreeBlocks();
-    bool findFreePages(size_t numPages, std::vector<uint32_t> &allocatedFrames);
-    bool swapOutOldestProcess();
+    bool allocateHuge(ProcessPageTable &entry, int pid, size_t requiredBytes);
+    void releaseHuge(ProcessPageTable &entry);
+    bool carveHugeFrame();
+    bool reassembleHugeFrame(uint32_t &index);
+    size_t getHugeFrameSize() const { return pageSize * hugeFrameFactor; }
+    size_t compactFlat();
+    double getExternalFragmentation() const;
+    PageTableShard &getShard(int pid) { return *pageTableShards[static_cast<size_t>(pid) % pageTableShards.size()]; }
+    bool submitPageIn(int pid, uint32_t pageNumber, bool isPrefetch, bool isWrite);
+    void finishPageIn(int pid, uint32_t pageNumber);
+    void ioLoop();
+    void servicePageIn(const IORequest &request);
+    bool evictVictim(uint32_t &frame, uint32_t &writeSlot);
+    void writebackCompressed();
+    void snapshotLoop();
+    void writeSnapshot(uint64_t cycle, MemorySnapshot &snapshot, std::vector<char> &record);
+    void captureSnapshot(uint64_t cycle, MemorySnapshot &snapshot);
+    static uint64_t pageKey(int pid, uint32_t pageNumber) { return (static_cast<uint64_t>(pid) << 32) | pageNumber; }
+    void reserveFrame(uint32_t frame, int pid, uint32_t pageNumber);
+    void mapFrame(uint32_t frame, ProcessPageTable &owner);
+    void touchFrame(uint32_t frame, bool isWrite);
+    void shootdown(int pid, uint32_t pageNumber);
+    void releaseFrame(uint32_t frame);
+    void clearFrame(uint32_t frame);
+    void discardFrame(uint32_t frame);
+    uint32_t acquireImage(const std::string &key);
+    bool mapImagePage(ProcessPageTable &owner, uint32_t pageNumber);
+    void installImagePage(uint32_t frame, ProcessPageTable &owner, uint32_t pageNumber);
+    void mapShared(uint32_t frame, ProcessPageTable &owner, uint32_t pageNumber);
+    void unmapShared(uint32_t frame);
+    bool imageFramesFull() const;
+    bool reclaimImageFrame(uint32_t &frame);
+    char *getFrameData(uint32_t frame) { return physicalMemory.get() + static_cast<size_t>(frame) * pageSize; }
 };
 
-#endif
\ No newline at end of file
+#endif
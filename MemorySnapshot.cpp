@@ -0,0 +1,165 @@
+#include "MemorySnapshot.h"
+#include <cstring>
+
+const char MemorySnapshot::MAGIC[4] = {'C', 'S', 'N', 'P'};
+const uint16_t MemorySnapshot::VERSION;
+const size_t MemorySnapshot::FILE_HEADER_SIZE;
+
+template <typename T>
+static void put(std::vector<char> &out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+// Bounds-checked reader over one record
+struct SnapshotReader
+{
+    const char *data;
+    size_t end;
+    size_t offset;
+
+    template <typename T>
+    bool get(T &value)
+    {
+        if (end - offset < sizeof(T))
+            return false;
+
+        uint64_t result = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            result |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+        }
+        value = static_cast<T>(result);
+        offset += sizeof(T);
+        return true;
+    }
+
+    // Rejects counts that could not fit in the bytes left
+    bool getCount(uint32_t &count, size_t entrySize)
+    {
+        return get(count) && static_cast<uint64_t>(count) * entrySize <= end - offset;
+    }
+};
+
+void MemorySnapshot::encodeFileHeader(std::vector<char> &out)
+{
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    put<uint16_t>(out, VERSION);
+    put<uint16_t>(out, 0);
+}
+
+bool MemorySnapshot::decodeFileHeader(const char *data, size_t size)
+{
+    if (size < FILE_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+
+    SnapshotReader reader = {data, FILE_HEADER_SIZE, sizeof(MAGIC)};
+    uint16_t version = 0;
+    return reader.get(version) && version == VERSION;
+}
+
+void MemorySnapshot::encode(std::vector<char> &out) const
+{
+    size_t lengthOffset = out.size();
+    put<uint32_t>(out, 0);
+
+    put<uint64_t>(out, cycle);
+    put<uint8_t>(out, isPaged ? 1 : 0);
+    put<uint32_t>(out, pageSize);
+    put<uint64_t>(out, totalBytes);
+    put<uint64_t>(out, usedBytes);
+    put<uint64_t>(out, largestFreeBlock);
+    put<uint64_t>(out, internalFragmentation);
+    put<uint16_t>(out, externalFragmentation);
+
+    put<uint32_t>(out, static_cast<uint32_t>(frames.size()));
+    for (const auto &frame : frames)
+    {
+        put<uint8_t>(out, frame.flags);
+        put<uint32_t>(out, frame.owner);
+        put<uint32_t>(out, frame.pageNumber);
+    }
+
+    put<uint32_t>(out, static_cast<uint32_t>(processes.size()));
+    for (const auto &process : processes)
+    {
+        put<uint32_t>(out, process.pid);
+        put<uint64_t>(out, process.address);
+        put<uint64_t>(out, process.size);
+        put<uint32_t>(out, process.residentPages);
+        put<uint32_t>(out, process.workingSet);
+    }
+
+    put<uint32_t>(out, static_cast<uint32_t>(blocks.size()));
+    for (const auto &block : blocks)
+    {
+        put<uint64_t>(out, block.address);
+        put<uint64_t>(out, block.size);
+        put<uint8_t>(out, block.isFree ? 1 : 0);
+    }
+
+    // Patch the length now that the body is known
+    uint32_t length = static_cast<uint32_t>(out.size() - lengthOffset - sizeof(uint32_t));
+    for (size_t i = 0; i < sizeof(length); ++i)
+    {
+        out[lengthOffset + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+}
+
+bool MemorySnapshot::decode(const char *data, size_t size, size_t &offset)
+{
+    SnapshotReader header = {data, size, offset};
+    uint32_t length = 0;
+    if (!header.get(length) || length > size - header.offset)
+        return false;
+
+    SnapshotReader reader = {data, header.offset + length, header.offset};
+    uint8_t mode = 0;
+    if (!reader.get(cycle) || !reader.get(mode) || !reader.get(pageSize) ||
+        !reader.get(totalBytes) || !reader.get(usedBytes) || !reader.get(largestFreeBlock) ||
+        !reader.get(internalFragmentation) || !reader.get(externalFragmentation))
+        return false;
+    isPaged = mode != 0;
+
+    uint32_t count = 0;
+    if (!reader.getCount(count, 9))
+        return false;
+    frames.resize(count);
+    for (auto &frame : frames)
+    {
+        reader.get(frame.flags);
+        reader.get(frame.owner);
+        reader.get(frame.pageNumber);
+    }
+
+    if (!reader.getCount(count, 28))
+        return false;
+    processes.resize(count);
+    for (auto &process : processes)
+    {
+        reader.get(process.pid);
+        reader.get(process.address);
+        reader.get(process.size);
+        reader.get(process.residentPages);
+        reader.get(process.workingSet);
+    }
+
+    if (!reader.getCount(count, 17))
+        return false;
+    blocks.resize(count);
+    for (auto &block : blocks)
+    {
+        uint8_t isFree = 0;
+        reader.get(block.address);
+        reader.get(block.size);
+        reader.get(isFree);
+        block.isFree = isFree != 0;
+    }
+
+    // Later versions may append fields; skip whatever this reader does not know
+    offset = reader.end;
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef MEMORY_SNAPSHOT_H
+#define MEMORY_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Point-in-time memory map, written as one binary record per snapshot and
+// read back by tools/snapshot-convert. All integers are little endian.
+//
+//   file:    "CSNP", u16 version, u16 reserved, records...
+//   record:  u32 length of the remaining bytes
+//            u64 cycle, u8 mode (0 flat, 1 paged), u32 page size
+//            u64 total, used and largest free bytes, u64 internal fragmentation
+//            u16 external fragmentation in basis points
+//            u32 count, frames    { u8 flags, u32 owner, u32 page }
+//            u32 count, processes { u32 pid, u64 address, u64 size, u32 resident, u32 working set }
+//            u32 count, blocks    { u64 address, u64 size, u8 free }
+struct MemorySnapshot
+{
+    static const char MAGIC[4];
+    static const uint16_t VERSION = 1;
+    static const size_t FILE_HEADER_SIZE = 8;
+
+    struct Frame
+    {
+        uint8_t flags; // FrameTable bits
+        uint32_t owner; // PID, or image ID for shared frames
+        uint32_t pageNumber;
+    };
+
+    struct ProcessEntry
+    {
+        uint32_t pid;
+        uint64_t address; // Block start in flat mode, 0 when paged
+        uint64_t size;
+        uint32_t residentPages;
+        uint32_t workingSet;
+    };
+
+    struct Block
+    {
+        uint64_t address;
+        uint64_t size;
+        bool isFree;
+    };
+
+    uint64_t cycle = 0;
+    bool isPaged = false;
+    uint32_t pageSize = 0;
+    uint64_t totalBytes = 0;
+    uint64_t usedBytes = 0;
+    uint64_t largestFreeBlock = 0;
+    uint64_t internalFragmentation = 0;
+    uint16_t externalFragmentation = 0;
+    std::vector<Frame> frames;
+    std::vector<ProcessEntry> processes;
+    std::vector<Block> blocks; // Flat mode only, in address order
+
+    static void encodeFileHeader(std::vector<char> &out);
+    static bool decodeFileHeader(const char *data, size_t size);
+
+    // Appends this snapshot as one length-prefixed record
+    void encode(std::vector<char> &out) const;
+
+    // Parses the record at offset and advances past it; false on a
+    // truncated or malformed record
+    bool decode(const char *data, size_t size, size_t &offset);
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef POISSON_ARRIVAL_MODEL_H
+#define POISSON_ARRIVAL_MODEL_H
+
+#include "IArrivalModel.h"
+
+// Independent arrivals at a mean rate of one per batch-process-freq cycles,
+// so gaps are exponentially distributed and a cycle may see several
+class PoissonArrivalModel : public IArrivalModel
+{
+public:
+    PoissonArrivalModel(uint32_t batchFreq) : batchFreq(batchFreq) {}
+
+    uint64_t arrivals(uint64_t from, uint64_t to) override
+    {
+        return samplePoisson(static_cast<double>(to - from) / batchFreq);
+    }
+    uint64_t nextArrival(uint64_t after) override { return after + sampleGap(batchFreq); }
+    std::string getName() const override { return "poisson"; }
+
+private:
+    uint32_t batchFreq;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <iomanip>
 #include <sstream>
 #include "CLI.h"
+#include "ProcessLogger.h"
 
 // PrintCommand::PrintCommand(int pid, const std::string &toPrint)
 //     : ICommand(pid, CommandType::PRINT), toPrint(toPrint)
@@ -16,22 +17,11 @@ PrintCommand::PrintCommand(int pid, const std::string &processName)
 {
 }
 
-void PrintCommand::execute()
+// The line is formatted and written later by the logger's writer thread;
+// the core only fills in a ring record
+void PrintCommand::execute(int coreID)
 {
-    // // Create log filename based on process ID
-    // std::string filename = "process_" + std::to_string(pid) + "_log.txt";
-    // std::ofstream logFile(filename, std::ios::app); // Open in append mode
-
-    // // Get current timestamp
-    // auto now = std::chrono::system_clock::now();
-    // std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    // std::tm localTime = *std::localtime(&now_c);
-
-    // // Write to log file with timestamp
-    // logFile << "("
-    //         << std::put_time(&localTime, "%m/%d/%Y %H:%M:%S%p")
-    //         << ") PID " << pid << ": " << toPrint << "\n";
-
+    ProcessLogger::getInstance().log(coreID, pid);
 }
 
 std::string PrintCommand::getLogDetails() const
@@ -11,12 +11,12 @@ public:
     // PrintCommand(int pid, const std::string &toPrint);
     PrintCommand(int pid, const std::string &processName);
 
-    void execute() override;
+    void execute(int coreID) override;
     std::string getLogDetails() const override;
 
 private:
     // std::string toPrint;
-    std::string processName;
+    const std::string &processName; // Owned by the process, which outlives its commands
 };
 
 #endif
\ No newline at end of file
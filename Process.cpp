@@ -5,45 +5,122 @@
 #include <chrono>
 #include <thread>
 #include <iomanip>
+#include <algorithm>
+#include <cassert>
 #include "Utils.h"
+#include "MemoryManager.h"
+#include "SlabPool.h"
+#include "ProcessStateLists.h"
+#include "Xoshiro256.h"
+#include "ProcessLogger.h"
 
-Process::Process(int pid, const std::string &name)
+Process::Process(int pid, const Spec &spec)
     : pid(pid),
-      name(name),
-      state(READY),
-      cpuCoreID(-1),
-      commandCounter(0),
-      quantumTime(0),
-      creationTime(std::chrono::system_clock::now()),
-      memoryRequirement(generateMemoryRequirement())
-{
-    // Generate random number of instructions based on config
-    int numInstructions = generateInstructionCount();
-
-    // Initialize with dummy instructions
-    for (int i = 0; i < numInstructions; ++i)
+      memoryRequirement(spec.memoryRequirement),
+      linesOfCode(0),
+      cold(new ColdFields)
+{
+    hot.state = READY;
+    hot.cpuCoreID = -1;
+    hot.commandCounter = 0;
+    hot.quantumTime = 0;
+
+    cold->programSeed = spec.programSeed;
+    cold->commandList = cold->program.allocateArray<ICommand *>(spec.instructionCount);
+    cold->commandCapacity = spec.instructionCount;
+
+    // Commands are drawn from the program's own generator, so the same seed
+    // always yields the same program
+    Xoshiro256 programRandom(spec.programSeed);
+    std::uniform_int_distribution<int> commandType(ICommand::PRINT, ICommand::PRINT);
+    for (int i = 0; i < spec.instructionCount; ++i)
     {
-        addCommand(ICommand::PRINT);
+        addCommand(static_cast<ICommand::CommandType>(commandType(programRandom)));
     }
 }
 
+Process::~Process()
+{
+    releaseProgram();
+}
+
+void Process::admit(const std::string &name)
+{
+    // Commands refer to the name in place, so assigning it here names them too
+    cold->name = name;
+    cold->creationTime = std::chrono::system_clock::now();
+    ProcessLogger::getInstance().registerProcess(pid, name);
+}
+
+void *Process::ColdFields::operator new(size_t size)
+{
+    assert(size == sizeof(ColdFields));
+    (void)size;
+    return SlabPool::get<sizeof(ColdFields), alignof(ColdFields)>().allocate();
+}
+
+void Process::ColdFields::operator delete(void *block)
+{
+    SlabPool::get<sizeof(ColdFields), alignof(ColdFields)>().deallocate(block);
+}
+
 void Process::addCommand(ICommand::CommandType commandType)
 {
-    if (commandType == ICommand::PRINT)
+    if (commandType != ICommand::PRINT)
+        return;
+
+    // A full table is copied to a larger one in the arena; the old copy is
+    // reclaimed with the rest of the program
+    if (linesOfCode == cold->commandCapacity)
     {
-        auto command = std::make_shared<PrintCommand>(pid, name);
-        commandList.push_back(command);
+        int capacity = std::max(16, cold->commandCapacity * 2);
+        ICommand **table = cold->program.allocateArray<ICommand *>(capacity);
+        std::copy(cold->commandList, cold->commandList + linesOfCode, table);
+        cold->commandList = table;
+        cold->commandCapacity = capacity;
     }
+
+    cold->commandList[linesOfCode++] = cold->program.create<PrintCommand>(pid, cold->name);
 }
 
-void Process::executeCurrentCommand(int coreID)
+void Process::archive()
 {
-    if (commandCounter < commandList.size())
+    std::lock_guard<std::mutex> lock(cold->processMutex);
+    releaseProgram();
+    ProcessLogger::getInstance().retireProcess(pid);
+}
+
+void Process::releaseProgram()
+{
+    if (!cold || !cold->commandList)
+        return;
+
+    for (int i = 0; i < linesOfCode; ++i)
+    {
+        cold->commandList[i]->~ICommand();
+    }
+    cold->program.release();
+    cold->commandList = nullptr;
+    cold->commandCapacity = 0;
+}
+
+bool Process::executeCurrentCommand(int coreID)
+{
+    if (hot.commandCounter < linesOfCode && cold->commandList)
     {
+        // Instruction fetch, then the output store into the data segment; either
+        // stalls until its page is resident and, for the store, private
+        auto &memoryManager = MemoryManager::getInstance();
+        if (!memoryManager.accessMemory(pid, getInstructionAddress(hot.commandCounter), false, coreID) ||
+            !memoryManager.accessMemory(pid, getDataAddress(hot.commandCounter), true, coreID))
+        {
+            return false;
+        }
+
         try
         {
             // Ensure thread-safe execution of the command
-            commandList[commandCounter]->execute();
+            cold->commandList[hot.commandCounter]->execute(coreID);
         }
         catch (const std::exception &e)
         {
@@ -51,96 +128,170 @@ void Process::executeCurrentCommand(int coreID)
                       << ": " << e.what() << std::endl;
         }
     }
+    return true;
 }
 
-void Process::moveToNextLine()
+const size_t Process::INSTRUCTION_SIZE;
+
+size_t Process::getCodeSize() const
+{
+    return std::min(linesOfCode * INSTRUCTION_SIZE, memoryRequirement * 1024);
+}
+
+size_t Process::getInstructionAddress(int line) const
 {
-    if (commandCounter < commandList.size())
+    if (linesOfCode == 0)
     {
-        ++commandCounter;
+        return 0;
     }
+    return (static_cast<size_t>(line) * getCodeSize()) / linesOfCode;
 }
 
-bool Process::isFinished()
+size_t Process::getDataAddress(int line) const
 {
-    return commandCounter >= commandList.size();
+    size_t codeSize = getCodeSize();
+    if (linesOfCode == 0)
+    {
+        return codeSize;
+    }
+
+    // Output lines are spread across the data segment
+    size_t dataSize = memoryRequirement * 1024 - codeSize;
+    return codeSize + (static_cast<size_t>(line) * dataSize) / linesOfCode;
 }
 
-int Process::generateInstructionCount() const
+std::string Process::getTextPageKey(size_t pageNumber, size_t pageSize) const
 {
-    auto &config = Config::getInstance();
-    int min = config.getMinInstructions();
-    int max = config.getMaxInstructions();
+    // The offset of the first line starting in the page, then the run-length
+    // encoded command types of the lines starting in it, e.g. "0:0x16;" for
+    // a page of 16 PRINTs. Text squeezed into a small process has its lines
+    // closer together, so its code size is part of the key.
+    size_t lines = cold->commandList ? linesOfCode : 0;
+    size_t codeSize = getCodeSize();
+    size_t begin = pageNumber * pageSize;
+    size_t end = begin + pageSize;
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(min, max);
+    // Line i starts at i * codeSize / lines, rounded down
+    size_t i = codeSize > 0 ? std::min(lines, (begin * lines + codeSize - 1) / codeSize) : lines;
+    std::string key;
+    if (codeSize < lines * INSTRUCTION_SIZE)
+    {
+        key += std::to_string(codeSize) + "/" + std::to_string(lines) + "@";
+    }
+    key += std::to_string(i < lines ? getInstructionAddress(static_cast<int>(i)) - begin : 0) + ":";
 
-    return dis(gen);
+    while (i < lines && getInstructionAddress(static_cast<int>(i)) < end)
+    {
+        ICommand::CommandType type = cold->commandList[i]->getCommandType();
+        size_t run = 0;
+        while (i < lines && getInstructionAddress(static_cast<int>(i)) < end &&
+               cold->commandList[i]->getCommandType() == type)
+        {
+            ++run;
+            ++i;
+        }
+        key += std::to_string(static_cast<int>(type)) + "x" + std::to_string(run) + ";";
+    }
+    return key;
 }
 
-size_t Process::generateMemoryRequirement() const
+void Process::moveToNextLine()
+{
+    if (hot.commandCounter < linesOfCode)
+    {
+        ++hot.commandCounter;
+    }
+}
+
+bool Process::isFinished()
+{
+    return hot.commandCounter >= linesOfCode;
+}
+
+Process::Spec Process::generateSpec(int pid)
 {
     auto &config = Config::getInstance();
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint32_t> dis(
-        config.getMinMemPerProc(),
-        config.getMaxMemPerProc());
-    return dis(gen);
+    Xoshiro256 seeded(config.getSeed(), static_cast<uint64_t>(pid));
+    Xoshiro256 &random = config.isDeterministic() ? seeded : Xoshiro256::local();
+
+    std::uniform_int_distribution<int> instructions(config.getMinInstructions(), config.getMaxInstructions());
+    std::uniform_int_distribution<uint32_t> memory(config.getMinMemPerProc(), config.getMaxMemPerProc());
+
+    Spec spec;
+    spec.instructionCount = instructions(random);
+    spec.memoryRequirement = memory(random);
+    spec.programSeed = random();
+    return spec;
 }
 
 void Process::displayProcessInfo()
 {
     std::string processInfo;
     {
-        std::lock_guard<std::mutex> lock(processMutex);
+        std::lock_guard<std::mutex> lock(cold->processMutex);
 
-        processInfo += name + " (" + formatTimestamp(creationTime) + ") ";
+        processInfo += cold->name + " (" + formatTimestamp(cold->creationTime) + ") ";
 
-        if (state == FINISHED)
+        if (hot.state == FINISHED)
         {
             processInfo += "Finished   " + std::to_string(getLinesOfCode()) + " / " + std::to_string(getLinesOfCode());
         }
         else
         {
-            processInfo += "Core: " + std::to_string(cpuCoreID) + "    " +
+            processInfo += "Core: " + std::to_string(hot.cpuCoreID) + "    " +
                            std::to_string(getCommandCounter()) + " / " + std::to_string(getLinesOfCode());
         }
     }
+
+    std::vector<std::string> logs = ProcessLogger::getInstance().tail(pid);
+    if (!logs.empty())
+    {
+        processInfo += "\nLogs:";
+        for (const auto &line : logs)
+        {
+            processInfo += "\n" + line;
+        }
+    }
     std::cout << processInfo << "\n";
 }
 
 // Getters and setters
 int Process::getPID() const { return pid; }
-std::string Process::getName() const { return name; }
+const std::string &Process::getName() const { return cold->name; }
 
 Process::ProcessState Process::getState()
 {
-    return state.load();
+    return hot.state.load();
 }
 
 void Process::setState(ProcessState newState)
 {
-    state.store(newState);
+    if (cold->stateLists)
+    {
+        cold->stateLists->transition(this, newState);
+    }
+    else
+    {
+        hot.state.store(newState);
+    }
 }
 
 void Process::setCPUCoreID(int id)
 {
-    cpuCoreID.store(id);
+    hot.cpuCoreID.store(id);
 }
 
 int Process::getCPUCoreID()
 {
-    return cpuCoreID.load();
+    return hot.cpuCoreID.load();
 }
 
 int Process::getCommandCounter()
 {
-    return commandCounter.load();
+    return hot.commandCounter.load();
 }
 
 int Process::getLinesOfCode()
 {
-    return static_cast<int>(commandList.size());
+    return linesOfCode;
 }
\ No newline at end of file
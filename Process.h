@@ -7,11 +7,15 @@
 #include <atomic>
 #include <mutex>
 #include <random>
+#include <chrono>
 #include "ICommand.h"
 #include "Config.h"
 #include "PrintCommand.h"
+#include "ProgramArena.h"
 
-class Process
+class ProcessStateLists;
+
+class Process : public std::enable_shared_from_this<Process>
 {
 public:
     enum ProcessState
@@ -22,21 +26,44 @@ public:
         FINISHED
     };
 
-    // Constructor
-    Process(int pid, const std::string &name);
+    // Everything that determines a process's workload; recorded in traces
+    // so a replay rebuilds the same process
+    struct Spec
+    {
+        int instructionCount;
+        size_t memoryRequirement; // KB
+        uint64_t programSeed;     // Drives the choice of each command
+    };
+
+    // Draws a spec within the configured instruction and memory ranges. In
+    // deterministic mode the draw depends only on the seed and the PID.
+    static Spec generateSpec(int pid);
+
+    // Builds the program; the process is nameless until admitted, so the
+    // ProcessFactory can build it ahead of the name being chosen
+    Process(int pid, const Spec &spec);
+    ~Process();
+
+    // Names the process and stamps its creation time. Called once, before
+    // the process is published to the table or scheduler.
+    void admit(const std::string &name);
 
     // Command management
     void addCommand(ICommand::CommandType commandType);
-    void executeCurrentCommand(int coreID);
+    bool executeCurrentCommand(int coreID);
     void moveToNextLine();
 
+    // Frees the program of a finished process in one step; the line count
+    // stays for display
+    void archive();
+
     // Process status
     bool isFinished();
     int getCommandCounter();
     int getLinesOfCode();
     ProcessState getState();
     void setState(ProcessState state);
-    std::chrono::system_clock::time_point getCreationTime() const { return creationTime; }
+    std::chrono::system_clock::time_point getCreationTime() const { return cold->creationTime; }
 
     // Core assignment
     void setCPUCoreID(int cpuCoreID);
@@ -44,40 +71,74 @@ public:
 
     // Process identification
     int getPID() const;
-    std::string getName() const;
+    const std::string &getName() const;
 
     // Round Robin support
-    void resetQuantumTime() { quantumTime = 0; }
-    uint32_t getQuantumTime() { return quantumTime.load(); }
-    void incrementQuantumTime() { ++quantumTime; }
+    void resetQuantumTime() { hot.quantumTime = 0; }
+    uint32_t getQuantumTime() { return hot.quantumTime.load(); }
+    void incrementQuantumTime() { ++hot.quantumTime; }
 
     // Process-smi command
     void displayProcessInfo();
 
     size_t getMemoryRequirement() const { return memoryRequirement; }
+    uint64_t getProgramSeed() const { return cold->programSeed; }
+
+    // Address space layout: program text first, then the data segment that
+    // each PRINT writes its output into
+    static const size_t INSTRUCTION_SIZE = 1024; // Bytes of program text per line
+    size_t getCodeSize() const;
+    size_t getInstructionAddress(int line) const;
+    size_t getDataAddress(int line) const;
+
+    // Text pages with the same key hold the same instructions, whatever
+    // process or page number they belong to, and share one frame
+    std::string getTextPageKey(size_t pageNumber, size_t pageSize) const;
 
 private:
-    // Basic process information
-    const int pid;
-    const std::string name;
-    std::atomic<ProcessState> state;
-    std::atomic<int> cpuCoreID;
-    std::chrono::system_clock::time_point creationTime;
+    // Written by the owning core every tick and polled by the CLI and
+    // monitoring threads
+    struct HotFields
+    {
+        std::atomic<ProcessState> state;
+        std::atomic<int> cpuCoreID;
+        std::atomic<int> commandCounter;
+        std::atomic<uint32_t> quantumTime;
+    };
 
-    size_t memoryRequirement;
+    // Set at creation and read rarely, kept in a separate allocation from
+    // a slab pool. Commands and their table live in the program arena. The
+    // state list links are only touched under the ProcessStateLists lock.
+    struct ColdFields
+    {
+        std::string name;
+        std::chrono::system_clock::time_point creationTime;
+        ProgramArena program;
+        ICommand **commandList = nullptr;
+        int commandCapacity = 0;
+        uint64_t programSeed = 0;
+        std::mutex processMutex;
+        ProcessStateLists *stateLists = nullptr;
+        Process *statePrev = nullptr;
+        Process *stateNext = nullptr;
+
+        static void *operator new(size_t size);
+        static void operator delete(void *block);
+    };
 
-    // Command management
-    std::vector<std::shared_ptr<ICommand>> commandList;
-    std::atomic<int> commandCounter;
+    // Read-mostly identification shares a line with the cold pointer only
+    const int pid;
+    size_t memoryRequirement;
+    int linesOfCode;
+    std::unique_ptr<ColdFields> cold;
 
-    // Round Robin timing
-    std::atomic<uint32_t> quantumTime;
+    // Not padded out to its own cache line: tools/process-contention
+    // compares that layout, and it showed no gain where it was measured
+    HotFields hot;
 
-    mutable std::mutex processMutex;
+    void releaseProgram();
 
-    // Generation methods
-    int generateInstructionCount() const;
-    size_t generateMemoryRequirement() const;
+    friend class ProcessStateLists;
 };
 
 #endif
@@ -0,0 +1,105 @@
+#include "ProcessFactory.h"
+#include "SlabPool.h"
+
+const size_t ProcessFactory::BUFFER_SIZE;
+
+std::shared_ptr<Process> ProcessFactory::take()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        startWorker();
+
+        if (!ready.empty())
+        {
+            std::shared_ptr<Process> process = std::move(ready.front());
+            ready.pop_front();
+            refill.notify_one();
+            return process;
+        }
+    }
+
+    return build();
+}
+
+std::vector<std::shared_ptr<Process>> ProcessFactory::take(size_t count)
+{
+    std::vector<std::shared_ptr<Process>> taken;
+    taken.reserve(count);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        startWorker();
+
+        while (taken.size() < count && !ready.empty())
+        {
+            taken.push_back(std::move(ready.front()));
+            ready.pop_front();
+        }
+    }
+    refill.notify_one();
+
+    while (taken.size() < count)
+    {
+        taken.push_back(build());
+    }
+    return taken;
+}
+
+void ProcessFactory::giveBack(const std::shared_ptr<Process> &process)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.push_front(process);
+}
+
+void ProcessFactory::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    refill.notify_all();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+// Caller holds the mutex. The worker starts on first use rather than at
+// construction, once the config it builds from has been loaded. In
+// deterministic mode there is no worker, so PIDs follow admission order.
+void ProcessFactory::startWorker()
+{
+    if (Config::getInstance().isDeterministic())
+        return;
+
+    if (!running && !worker.joinable())
+    {
+        running = true;
+        worker = std::thread(&ProcessFactory::workerLoop, this);
+    }
+}
+
+std::shared_ptr<Process> ProcessFactory::build()
+{
+    int pid = pidCounter++;
+    return std::allocate_shared<Process>(SlabAllocator<Process>(), pid, Process::generateSpec(pid));
+}
+
+// Programs are generated without the lock held; the lock only covers the
+// push, so a take never waits on a build in progress
+void ProcessFactory::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        refill.wait(lock, [this]
+                    { return !running || ready.size() < BUFFER_SIZE; });
+        if (!running)
+            break;
+
+        lock.unlock();
+        std::shared_ptr<Process> process = build();
+        lock.lock();
+        ready.push_back(std::move(process));
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef PROCESS_FACTORY_H
+#define PROCESS_FACTORY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Process.h"
+
+// Builds processes ahead of demand on a worker thread and keeps up to
+// BUFFER_SIZE of them ready, so admitting a process is a queue pop rather
+// than generating its program on the caller's thread. Buffered processes
+// have a PID but no name until admitted.
+class ProcessFactory
+{
+public:
+    static const size_t BUFFER_SIZE = 16;
+
+    // PIDs are drawn from the given counter as processes are built
+    explicit ProcessFactory(std::atomic<int> &pidCounter) : pidCounter(pidCounter), running(false) {}
+    ~ProcessFactory() { stop(); }
+
+    ProcessFactory(const ProcessFactory &) = delete;
+    ProcessFactory &operator=(const ProcessFactory &) = delete;
+
+    // Pops a ready process, starting the worker on first use. Builds one
+    // on the calling thread if the buffer has run dry.
+    std::shared_ptr<Process> take();
+
+    // Takes count processes under one lock, building any shortfall on the
+    // calling thread
+    std::vector<std::shared_ptr<Process>> take(size_t count);
+
+    // Puts back a process that was taken but not admitted, keeping PIDs
+    // in order for the next take
+    void giveBack(const std::shared_ptr<Process> &process);
+
+    void stop();
+
+private:
+    std::atomic<int> &pidCounter;
+    std::deque<std::shared_ptr<Process>> ready; // Guarded by mutex
+    bool running;                               // Guarded by mutex
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable refill;
+
+    void startWorker();
+    std::shared_ptr<Process> build();
+    void workerLoop();
+};
+
+#endif
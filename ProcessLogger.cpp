@@ -0,0 +1,275 @@
+#include "ProcessLogger.h"
+#include "Config.h"
+#include "Utils.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+const size_t ProcessLogger::RING_CAPACITY;
+
+void ProcessLogger::initialize()
+{
+    shutdown();
+
+    auto &config = Config::getInstance();
+    std::string output = config.getLogOutput();
+    if (output == "off")
+        return;
+
+    mode = output == "per-process" ? PER_PROCESS : output == "indexed" ? INDEXED : SHARED;
+    tailLines = config.getLogTailLines();
+    if (mode == SHARED)
+    {
+        sharedStream.open(config.getLogFile(), std::ios::binary | std::ios::app);
+        if (!sharedStream)
+        {
+            throw std::runtime_error("Could not open process log: " + config.getLogFile());
+        }
+    }
+    else if (mode == INDEXED)
+    {
+        store.open(config.getLogFile(), static_cast<size_t>(config.getLogSegmentSize()) * 1024);
+    }
+
+    for (int core = 0; core < config.getNumCPU(); ++core)
+    {
+        rings.push_back(std::unique_ptr<Ring>(new Ring));
+    }
+
+    running = true;
+    writer = std::thread(&ProcessLogger::writerLoop, this);
+}
+
+void ProcessLogger::shutdown()
+{
+    running = false;
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+
+    rings.clear();
+    if (sharedStream.is_open())
+    {
+        sharedStream.close();
+    }
+    store.close();
+}
+
+void ProcessLogger::registerProcess(int pid, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(namesMutex);
+    names[pid] = name;
+}
+
+void ProcessLogger::retireProcess(int pid)
+{
+    std::lock_guard<std::mutex> lock(namesMutex);
+    retired.push_back(pid);
+}
+
+std::vector<std::string> ProcessLogger::tail(int pid) const
+{
+    if (mode != INDEXED || tailLines == 0)
+        return std::vector<std::string>();
+
+    return store.tail(pid, tailLines);
+}
+
+uint64_t ProcessLogger::getDropped() const
+{
+    uint64_t dropped = 0;
+    for (const auto &ring : rings)
+    {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void ProcessLogger::writerLoop()
+{
+    std::vector<Record> batch;
+    batch.reserve(RING_CAPACITY);
+
+    std::vector<int> retiring;
+    while (running)
+    {
+        // Taken before draining, so whatever a process logged before it was
+        // retired is written first
+        {
+            std::lock_guard<std::mutex> lock(namesMutex);
+            retiring.swap(retired);
+        }
+
+        size_t written = drainOnce(batch);
+        forget(retiring);
+        if (written == 0 && retiring.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        retiring.clear();
+    }
+
+    // Whatever the cores logged before stopping
+    while (drainOnce(batch) > 0)
+    {
+    }
+}
+
+// Moves every record published so far out of the rings and writes them
+// as one batch; returns the number of records written
+size_t ProcessLogger::drainOnce(std::vector<Record> &batch)
+{
+    batch.clear();
+    for (const auto &ring : rings)
+    {
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        uint64_t tail = ring->tail.load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+        {
+            batch.push_back(ring->records[head & (RING_CAPACITY - 1)]);
+        }
+        ring->head.store(tail, std::memory_order_release);
+    }
+
+    if (!batch.empty())
+    {
+        writeBatch(batch);
+    }
+    return batch.size();
+}
+
+void ProcessLogger::writeBatch(const std::vector<Record> &batch)
+{
+    // Rings are drained one after another, so lines are put back in time
+    // order across cores before writing
+    std::vector<const Record *> ordered;
+    ordered.reserve(batch.size());
+    for (const auto &record : batch)
+    {
+        ordered.push_back(&record);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const Record *a, const Record *b)
+                     { return a->timestamp < b->timestamp; });
+
+    // Map nodes never move and only this thread erases them, so the names
+    // can be read after the lock is dropped
+    std::vector<const std::string *> recordNames;
+    recordNames.reserve(ordered.size());
+    {
+        static const std::string unknown = "?";
+        std::lock_guard<std::mutex> lock(namesMutex);
+        for (const Record *record : ordered)
+        {
+            auto it = names.find(record->pid);
+            recordNames.push_back(it != names.end() ? &it->second : &unknown);
+        }
+    }
+
+    // Timestamps only have second resolution, so each second is formatted once
+    struct ProcessBuffer
+    {
+        const std::string *name;
+        std::string text;
+    };
+    std::string buffer;
+    std::string line;
+    std::unordered_map<int, ProcessBuffer> processBuffers;
+    size_t lines = ordered.size();
+    size_t bytes = 0;
+    int64_t formattedSecond = -1;
+    std::string formattedTime;
+    for (size_t i = 0; i < ordered.size(); ++i)
+    {
+        const Record &record = *ordered[i];
+        std::chrono::system_clock::duration since(record.timestamp);
+        int64_t second = std::chrono::duration_cast<std::chrono::seconds>(since).count();
+        if (second != formattedSecond)
+        {
+            formattedSecond = second;
+            formattedTime = formatTimestamp(std::chrono::system_clock::time_point(since));
+        }
+
+        // Same text as PrintCommand::getLogDetails
+        std::string *target = &buffer;
+        if (mode == INDEXED)
+        {
+            line.clear();
+            target = &line;
+        }
+        else if (mode == PER_PROCESS)
+        {
+            ProcessBuffer &processBuffer = processBuffers[record.pid];
+            processBuffer.name = recordNames[i];
+            target = &processBuffer.text;
+        }
+        std::string &out = *target;
+        out += "(";
+        out += formattedTime;
+        out += ") Core:";
+        out += std::to_string(record.coreID);
+        out += " \"Hello world from ";
+        out += *recordNames[i];
+        out += "\"\n";
+
+        // The store keeps lines without their newline. Lines after a failed
+        // append are not written, and not counted.
+        if (mode == INDEXED)
+        {
+            try
+            {
+                store.append(record.pid, line.data(), line.size() - 1);
+                bytes += line.size();
+            }
+            catch (const LogStore::LogStoreException &e)
+            {
+                std::cerr << "Process log: " << e.what() << "\n";
+                lines = i;
+                break;
+            }
+        }
+    }
+
+    if (mode == PER_PROCESS)
+    {
+        for (const auto &entry : processBuffers)
+        {
+            const ProcessBuffer &processBuffer = entry.second;
+            std::ofstream file(*processBuffer.name + ".txt", std::ios::binary | std::ios::app);
+            file.write(processBuffer.text.data(), processBuffer.text.size());
+            bytes += processBuffer.text.size();
+        }
+    }
+    else if (mode == SHARED)
+    {
+        sharedStream.write(buffer.data(), buffer.size());
+        sharedStream.flush();
+        bytes = buffer.size();
+    }
+
+    linesWritten.fetch_add(lines, std::memory_order_relaxed);
+    bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    batchesWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ProcessLogger::forget(const std::vector<int> &pids)
+{
+    if (pids.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(namesMutex);
+        for (int pid : pids)
+        {
+            names.erase(pid);
+        }
+    }
+
+    if (mode == INDEXED)
+    {
+        for (int pid : pids)
+        {
+            store.archive(pid, tailLines);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef PROCESS_LOGGER_H
+#define PROCESS_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "LogStore.h"
+
+// Process output log. Cores append fixed-size records to their own
+// single-producer ring without locking; one writer thread drains every
+// ring, formats the lines and writes them in large batches to a shared
+// file, to one file per process or to an indexed LogStore that can return
+// a process's latest lines. A full ring drops records rather than stall
+// its core.
+class ProcessLogger
+{
+public:
+    static ProcessLogger &getInstance()
+    {
+        static ProcessLogger instance;
+        return instance;
+    }
+
+    static const size_t RING_CAPACITY = 8192; // Records per core, a power of two
+
+    // Sets up one ring per core and starts the writer if log-output is not
+    // off; throws std::runtime_error if the shared log cannot be created
+    void initialize();
+
+    // Drains every ring and stops the writer
+    void shutdown();
+
+    // Names are looked up by the writer; a process registers once, when
+    // it is admitted
+    void registerProcess(int pid, const std::string &name);
+
+    // Called when a process is archived, or dropped after a failed
+    // admission. The writer forgets the process
+    // after writing what it logged, and drops all but its last
+    // log-tail-lines lines from the store, so they can still be shown.
+    void retireProcess(int pid);
+
+    // The process's latest log-tail-lines lines, oldest first; empty unless
+    // log-output is indexed
+    std::vector<std::string> tail(int pid) const;
+
+    // Called on the core running the process. Only one thread appends to
+    // a core's ring at a time, which the scheduler guarantees.
+    void log(int coreID, int pid)
+    {
+        if (coreID < 0 || static_cast<size_t>(coreID) >= rings.size())
+            return;
+
+        Ring &ring = *rings[coreID];
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        if (tail - ring.head.load(std::memory_order_acquire) >= RING_CAPACITY)
+        {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Record &record = ring.records[tail & (RING_CAPACITY - 1)];
+        record.timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+        record.pid = pid;
+        record.coreID = coreID;
+        ring.tail.store(tail + 1, std::memory_order_release);
+    }
+
+    bool isEnabled() const { return !rings.empty(); }
+    bool isIndexed() const { return mode == INDEXED; }
+    LogStore::Stats getStoreStats() const { return store.getStats(); }
+    uint64_t getLinesWritten() const { return linesWritten.load(std::memory_order_relaxed); }
+    uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+    uint64_t getBatchesWritten() const { return batchesWritten.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const;
+
+private:
+    ProcessLogger() : mode(SHARED), tailLines(0), running(false), linesWritten(0), bytesWritten(0), batchesWritten(0) {}
+    ~ProcessLogger() { shutdown(); }
+
+    ProcessLogger(const ProcessLogger &) = delete;
+    ProcessLogger &operator=(const ProcessLogger &) = delete;
+
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    struct Record
+    {
+        int64_t timestamp; // system_clock ticks
+        int32_t pid;
+        int32_t coreID;
+    };
+
+    // The producer owns tail and the writer owns head; each sits on its
+    // own cache line
+    struct Ring
+    {
+        std::atomic<uint64_t> tail{0};
+        char tailPadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> head{0};
+        char headPadding[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> dropped{0};
+        std::unique_ptr<Record[]> records{new Record[RING_CAPACITY]};
+    };
+
+    enum OutputMode
+    {
+        SHARED,
+        PER_PROCESS,
+        INDEXED
+    };
+
+    std::vector<std::unique_ptr<Ring>> rings; // Fixed between initialize and shutdown
+    OutputMode mode;
+    size_t tailLines;
+    std::ofstream sharedStream;
+    LogStore store;
+
+    std::mutex namesMutex;
+    std::unordered_map<int, std::string> names; // Guarded by namesMutex
+    std::vector<int> retired;                   // Guarded by namesMutex
+
+    std::thread writer;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> linesWritten;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> batchesWritten;
+
+    void writerLoop();
+    size_t drainOnce(std::vector<Record> &batch);
+    void writeBatch(const std::vector<Record> &batch);
+    void forget(const std::vector<int> &pids);
+};
+
+#endif
@@ -1,10 +1,13 @@
 #include "ProcessManager.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <chrono>
 #include "Utils.h"
 #include "MemoryManager.h"
+#include "SlabPool.h"
+#include "ProcessLogger.h"
 
 void ProcessManager::createProcess(const std::string &name)
 {
@@ -18,70 +21,335 @@ void ProcessManager::createProcess(const std::string &name)
         throw std::runtime_error("Memory Manager not initialized");
     }
 
-    std::unique_lock<std::mutex> lock(processesMutex);
-    if (processes.find(name) != processes.end())
+    // The program is already built, so the table lock covers only naming and
+    // insertion. The slot reserves the name, so memory is allocated without
+    // holding the lock and the entry is dropped again if allocation fails.
+    ProcessTable::Handle handle;
+    std::shared_ptr<Process> process = factory.take();
     {
-        throw std::runtime_error("Process with name '" + name + "' already exists");
+        std::lock_guard<std::mutex> lock(processesMutex);
+        if (processes.find(name))
+        {
+            factory.giveBack(process);
+            throw std::runtime_error("Process with name '" + name + "' already exists");
+        }
+
+        process->admit(name);
+        processes.insert(process, handle);
+        stateLists.add(process.get());
     }
 
     try
     {
-        // Create process first
-        auto process = std::make_shared<Process>(nextPID++, name);
-
-        // Try to allocate memory
         if (!MemoryManager::getInstance().allocateMemory(process))
         {
             throw std::runtime_error("Failed to allocate memory for process '" + name + "'");
         }
-
-        processes[name] = process;
-        lock.unlock();
-        Scheduler::getInstance().addProcess(process);
     }
     catch (const std::exception &e)
     {
+        {
+            std::lock_guard<std::mutex> lock(processesMutex);
+            stateLists.remove(process.get());
+            processes.remove(handle);
+        }
         std::cerr << "Failed to create process: " << e.what() << std::endl;
         throw;
     }
+
+    recordAdmissions({process});
+    Scheduler::getInstance().addProcess(process);
 }
 
-std::shared_ptr<Process> ProcessManager::getProcess(const std::string &name)
+size_t ProcessManager::createProcesses(size_t count)
 {
-    std::shared_ptr<Process> result;
+    if (!MemoryManager::getInstance().isInitialized())
     {
-        std::lock_guard<std::mutex> lock(processesMutex);
-        auto it = processes.find(name);
-        if (it != processes.end())
-        {
-            result = it->second;
-        }
+        throw std::runtime_error("Memory Manager not initialized");
+    }
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::ostringstream name;
+        name << "p" << std::setfill('0') << std::setw(2) << batchCounter++;
+        names.push_back(name.str());
     }
-    return result;
+
+    return admitProcesses(factory.take(count), names, true);
 }
 
-void ProcessManager::listProcesses()
+// Names and inserts the batch under one table lock, allocates memory for
+// each outside it, and hands the survivors to the scheduler together.
+// Processes whose name is taken go back to the factory if they came from it.
+size_t ProcessManager::admitProcesses(std::vector<std::shared_ptr<Process>> batch,
+                                      const std::vector<std::string> &names, bool fromFactory)
 {
-    std::vector<std::shared_ptr<Process>> processSnapshot;
-    int totalCores;
-    size_t totalMemory = MemoryManager::getInstance().getTotalMemory();
-    size_t usedMemory = MemoryManager::getInstance().getUsedMemory();
-    int activeCount = 0;
-
+    std::vector<std::shared_ptr<Process>> unused;
+    std::vector<ProcessTable::Handle> handles(batch.size());
     {
         std::lock_guard<std::mutex> lock(processesMutex);
-        totalCores = Config::getInstance().getNumCPU();
+        size_t named = 0;
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (processes.find(names[i]))
+            {
+                std::cerr << "Failed to create process: Process with name '" << names[i]
+                          << "' already exists" << std::endl;
+                unused.push_back(batch[i]);
+                continue;
+            }
+
+            batch[i]->admit(names[i]);
+            processes.insert(batch[i], handles[named]);
+            batch[named++] = batch[i];
+        }
+        batch.resize(named);
+        stateLists.add(batch);
+    }
+
+    if (fromFactory)
+    {
+        for (auto it = unused.rbegin(); it != unused.rend(); ++it)
+        {
+            factory.giveBack(*it);
+        }
+    }
 
-        for (const auto &pair : processes)
+    // Memory is allocated per process; any that fail are dropped from the
+    // table together afterwards
+    std::vector<std::shared_ptr<Process>> admitted;
+    std::vector<size_t> failed;
+    admitted.reserve(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        try
         {
-            processSnapshot.push_back(pair.second);
-            if (pair.second->getState() == Process::RUNNING)
+            if (!MemoryManager::getInstance().allocateMemory(batch[i]))
             {
-                activeCount++;
+                throw std::runtime_error("Failed to allocate memory for process '" + batch[i]->getName() + "'");
             }
+            admitted.push_back(batch[i]);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Failed to create process: " << e.what() << std::endl;
+            failed.push_back(i);
         }
     }
 
+    if (!failed.empty())
+    {
+        std::lock_guard<std::mutex> lock(processesMutex);
+        for (size_t i : failed)
+        {
+            stateLists.remove(batch[i].get());
+            processes.remove(handles[i]);
+            // Never ran, so the logger only has its name to release
+            ProcessLogger::getInstance().retireProcess(batch[i]->getPID());
+        }
+    }
+
+    recordAdmissions(admitted);
+    Scheduler::getInstance().addProcesses(admitted);
+    return admitted.size();
+}
+
+void ProcessManager::initialize()
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (traceStream.is_open())
+    {
+        traceStream.close();
+    }
+
+    std::string traceFile = Config::getInstance().getTraceFile();
+    if (traceFile.empty())
+        return;
+
+    traceStream.open(traceFile, std::ios::binary | std::ios::trunc);
+    if (!traceStream)
+    {
+        throw std::runtime_error("Could not create trace file: " + traceFile);
+    }
+
+    std::vector<char> header;
+    WorkloadTrace::encodeFileHeader(header);
+    traceStream.write(header.data(), header.size());
+    traceStream.flush();
+    lastTraceCycle = 0;
+}
+
+void ProcessManager::recordAdmissions(const std::vector<std::shared_ptr<Process>> &admitted)
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (!traceStream.is_open() || admitted.empty())
+        return;
+
+    // Read under the lock so records from different admitting threads stay
+    // in cycle order
+    uint64_t cycle = Scheduler::getInstance().getCPUCycles();
+    std::vector<char> records;
+    for (const auto &process : admitted)
+    {
+        WorkloadTrace::Admission admission;
+        admission.cycle = cycle;
+        admission.name = process->getName();
+        admission.instructionCount = static_cast<uint32_t>(process->getLinesOfCode());
+        admission.memoryRequirement = static_cast<uint32_t>(process->getMemoryRequirement());
+        admission.programSeed = process->getProgramSeed();
+        WorkloadTrace::encode(admission, lastTraceCycle, records);
+        lastTraceCycle = cycle;
+    }
+    traceStream.write(records.data(), records.size());
+    traceStream.flush();
+}
+
+size_t ProcessManager::replay(const std::string &path)
+{
+    if (!MemoryManager::getInstance().isInitialized())
+    {
+        throw std::runtime_error("Memory Manager not initialized");
+    }
+
+    std::vector<WorkloadTrace::Admission> admissions = WorkloadTrace::load(path);
+    if (admissions.empty())
+    {
+        throw std::runtime_error("Trace file has no admissions: " + path);
+    }
+
+    std::lock_guard<std::mutex> lock(batchMutex);
+    if (replayActive)
+    {
+        throw std::runtime_error("A replay is already running");
+    }
+    if (replayThread.joinable())
+    {
+        replayThread.join();
+    }
+
+    size_t count = admissions.size();
+    replayAdmissions = std::move(admissions);
+    replayNext = 0;
+    replayStart = Scheduler::getInstance().getCPUCycles();
+    replayActive = true;
+    if (Config::getInstance().isSingleThreaded())
+    {
+        updateArrivalHook();
+    }
+    else
+    {
+        replayThread = std::thread(&ProcessManager::replayLoop, this);
+    }
+    return count;
+}
+
+void ProcessManager::stopReplay()
+{
+    std::lock_guard<std::mutex> lock(batchMutex);
+    bool wasActive = replayActive.exchange(false);
+    if (replayThread.joinable())
+    {
+        replayThread.join();
+    }
+    if (wasActive)
+    {
+        updateArrivalHook();
+    }
+}
+
+// Driven by the scheduler clock like the batch thread, waking on the cycle
+// the next admission is due
+void ProcessManager::replayLoop()
+{
+    auto &scheduler = Scheduler::getInstance();
+    uint64_t cycle = scheduler.getCPUCycles();
+    while (replayActive)
+    {
+        uint64_t next = admitReplay(cycle);
+        if (next == UINT64_MAX)
+            break;
+
+        // The timeout only bounds how long stopping takes
+        cycle = scheduler.waitForCycle(next - 1, std::chrono::milliseconds(50));
+    }
+}
+
+// Admissions keep their recorded spacing in cycles, counted from the first
+// one. Processes are built from the recorded specs rather than taken from
+// the factory, so they match the originals whatever the current config.
+uint64_t ProcessManager::admitReplay(uint64_t currentCycle)
+{
+    uint64_t origin = replayAdmissions.front().cycle;
+    std::vector<std::shared_ptr<Process>> batch;
+    std::vector<std::string> names;
+    while (replayNext < replayAdmissions.size() &&
+           replayStart + (replayAdmissions[replayNext].cycle - origin) <= currentCycle)
+    {
+        const WorkloadTrace::Admission &admission = replayAdmissions[replayNext++];
+        Process::Spec spec;
+        spec.instructionCount = static_cast<int>(admission.instructionCount);
+        spec.memoryRequirement = admission.memoryRequirement;
+        spec.programSeed = admission.programSeed;
+        batch.push_back(std::allocate_shared<Process>(SlabAllocator<Process>(), nextPID++, spec));
+        names.push_back(admission.name);
+    }
+
+    if (!batch.empty())
+    {
+        admitProcesses(std::move(batch), names, false);
+    }
+
+    if (replayNext < replayAdmissions.size())
+        return replayStart + (replayAdmissions[replayNext].cycle - origin);
+
+    replayActive = false;
+    return UINT64_MAX;
+}
+
+// Single-threaded runs admit batch arrivals and replayed processes on the
+// scheduler thread, at the same point in the cycle, through one hook that
+// asks to be called again at the earlier of the two. Callers hold
+// batchMutex.
+void ProcessManager::updateArrivalHook()
+{
+    if (!Config::getInstance().isSingleThreaded())
+        return;
+
+    if (!batchProcessingActive && !replayActive)
+    {
+        Scheduler::getInstance().setArrivalHook(nullptr);
+        return;
+    }
+
+    Scheduler::getInstance().setArrivalHook([this](uint64_t cycle)
+                                            {
+        uint64_t next = UINT64_MAX;
+        if (batchProcessingActive)
+        {
+            next = admitArrivals(cycle);
+        }
+        if (replayActive)
+        {
+            next = std::min(next, admitReplay(cycle));
+        }
+        return next; });
+}
+
+std::shared_ptr<Process> ProcessManager::getProcess(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(processesMutex);
+    return processes.find(name);
+}
+
+void ProcessManager::listProcesses(size_t offset, size_t limit)
+{
+    int totalCores = Config::getInstance().getNumCPU();
+    size_t totalMemory = MemoryManager::getInstance().getTotalMemory();
+    size_t usedMemory = MemoryManager::getInstance().getUsedMemory();
+    int activeCount = static_cast<int>(stateLists.count(Process::RUNNING));
+
     // Display memory in KB
     std::cout << "Memory Usage: " << (usedMemory / 1024) << "KB/"
               << (totalMemory / 1024) << "KB ("
@@ -90,30 +358,51 @@ void ProcessManager::listProcesses()
     std::cout << "Cores used: " << activeCount << "\n";
     std::cout << "Cores available: " << (totalCores - activeCount) << "\n\n";
 
-    std::cout << "Running processes:\n";
-    for (const auto &process : processSnapshot)
+    // The sections are paged as one listing, running processes first, so
+    // the finished page starts where the running processes run out
+    size_t runningTotal;
+    std::vector<std::shared_ptr<Process>> running = stateLists.collect(Process::RUNNING, offset, limit, runningTotal);
+    size_t finishedOffset = offset > runningTotal ? offset - runningTotal : 0;
+    size_t finishedTotal;
+    std::vector<std::shared_ptr<Process>> finished =
+        stateLists.collect(Process::FINISHED, finishedOffset, limit - running.size(), finishedTotal);
+
+    listSection("Running processes", running, offset, runningTotal, true);
+    std::cout << "\n";
+    listSection("Finished processes", finished, finishedOffset, finishedTotal, false);
+}
+
+// Prints one page of a state list, which starts offset entries in; the
+// range is noted only when the page leaves some of the list out
+void ProcessManager::listSection(const char *title, const std::vector<std::shared_ptr<Process>> &page,
+                                 size_t offset, size_t total, bool showMemory)
+{
+    std::cout << title;
+    if (page.empty() && total > 0)
     {
-        if (process->getState() == Process::RUNNING)
-        {
-            process->displayProcessInfo();
-            // Memory requirement is already in KB
-            std::cout << "Memory: " << process->getMemoryRequirement() << "KB\n";
-        }
+        std::cout << " (none of " << total << ")";
+    }
+    else if (page.size() < total)
+    {
+        std::cout << " (" << (offset + 1) << "-" << (offset + page.size()) << " of " << total << ")";
     }
+    std::cout << ":\n";
 
-    std::cout << "\nFinished processes:\n";
-    for (const auto &process : processSnapshot)
+    for (const auto &process : page)
     {
-        if (process->getState() == Process::FINISHED)
+        process->displayProcessInfo();
+        if (showMemory)
         {
-            process->displayProcessInfo();
+            // Memory requirement is already in KB
+            std::cout << "Memory: " << process->getMemoryRequirement() << "KB\n";
         }
     }
 }
 
 void ProcessManager::startBatchProcessing()
 {
-    if (!Config::getInstance().isInitialized())
+    auto &config = Config::getInstance();
+    if (!config.isInitialized())
     {
         throw std::runtime_error("System must be initialized before starting batch processing");
     }
@@ -122,8 +411,21 @@ void ProcessManager::startBatchProcessing()
         std::lock_guard<std::mutex> lock(batchMutex);
         if (!batchProcessingActive)
         {
+            // A replay's hook may already be running, so the model is in
+            // place before the flag is set
+            arrivalModel = IArrivalModel::create(config.getArrivalModel(), config.getBatchProcessFreq(),
+                                                 config.getBurstOnCycles(), config.getBurstOffCycles());
+            lastArrivalCycle = Scheduler::getInstance().getCPUCycles();
             batchProcessingActive = true;
-            batchProcessThread = std::thread(&ProcessManager::batchProcessingLoop, this);
+
+            if (config.isSingleThreaded())
+            {
+                updateArrivalHook();
+            }
+            else
+            {
+                batchProcessThread = std::thread(&ProcessManager::batchProcessingLoop, this);
+            }
         }
     }
 }
@@ -139,55 +441,62 @@ void ProcessManager::stopBatchProcessing()
             {
                 batchProcessThread.join();
             }
+            updateArrivalHook();
         }
     }
 }
 
+// Driven by the scheduler clock rather than polling it, so every cycle's
+// arrivals are admitted together however fast the clock runs
 void ProcessManager::batchProcessingLoop()
 {
-    int processCounter = 1;
-    uint64_t lastCycle = Scheduler::getInstance().getCPUCycles();
-    const uint64_t batchFreq = Config::getInstance().getBatchProcessFreq();
-
     while (batchProcessingActive)
     {
-        uint64_t currentCycle = Scheduler::getInstance().getCPUCycles();
+        // The timeout only bounds how long stopping takes
+        admitArrivals(Scheduler::getInstance().waitForCycle(lastArrivalCycle, std::chrono::milliseconds(50)));
+    }
+}
 
-        // Check if enough cycles have passed since last process creation
-        if ((currentCycle - lastCycle) >= batchFreq)
-        {
-            std::ostringstream processName;
-            processName << "p" << std::setfill('0') << std::setw(2) << processCounter++;
+uint64_t ProcessManager::admitArrivals(uint64_t currentCycle)
+{
+    uint64_t arrivals = arrivalModel->arrivals(lastArrivalCycle, currentCycle);
+    uint64_t nextArrival = arrivalModel->nextArrival(currentCycle);
+    lastArrivalCycle = currentCycle;
+    if (arrivals == 0)
+        return nextArrival;
 
-            try
-            {
-                createProcess(processName.str());
-                lastCycle = currentCycle; // Update last creation cycle
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "Error creating batch process: " << e.what() << std::endl;
-            }
-        }
+    // New processes would only add to the thrashing while memory is
+    // overcommitted, and are deferred while the largest of them might not
+    // fit in the frames and swap left
+    auto &memoryManager = MemoryManager::getInstance();
+    size_t largest = static_cast<size_t>(Config::getInstance().getMaxMemPerProc()) * 1024;
+    if (memoryManager.isOvercommitted() || Scheduler::getInstance().getSuspendedCount() > 0 ||
+        !memoryManager.canCommit(arrivals * largest))
+    {
+        throttledBatches += arrivals;
+        return nextArrival;
+    }
 
-        // Longer sleep time to reduce CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    try
+    {
+        createProcesses(arrivals);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error creating batch process: " << e.what() << std::endl;
     }
+    return nextArrival;
 }
 
 void ProcessManager::listProcessesWithMemory()
 {
-    std::lock_guard<std::mutex> lock(processesMutex);
-    for (const auto &pair : processes)
+    size_t total;
+    for (const auto &process : stateLists.collect(Process::RUNNING, 0, SIZE_MAX, total))
     {
-        auto process = pair.second;
-        if (process && process->getState() == Process::RUNNING)
-        {
-            // Convert KB to MiB for display
-            double memMiB = process->getMemoryRequirement() / 1024.0;
-            std::cout << std::left << std::setw(10) << process->getName()
-                      << std::fixed << std::setprecision(0) << memMiB << "MiB\n";
-        }
+        // Convert KB to MiB for display
+        double memMiB = process->getMemoryRequirement() / 1024.0;
+        std::cout << std::left << std::setw(10) << process->getName()
+                  << std::fixed << std::setprecision(0) << memMiB << "MiB\n";
     }
 }
 
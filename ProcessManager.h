@@ -1,13 +1,19 @@
 #ifndef PROCESS_MANAGER_H
 #define PROCESS_MANAGER_H
 
-#include <map>
+#include <cstdint>
+#include <fstream>
 #include <string>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include "Process.h"
+#include "ProcessTable.h"
+#include "ProcessStateLists.h"
+#include "ProcessFactory.h"
 #include "Scheduler.h"
+#include "WorkloadTrace.h"
+#include "IArrivalModel.h"
 
 class ProcessManager
 {
@@ -18,27 +24,94 @@ public:
         return instance;
     }
 
+    // Opens the workload trace if trace-file is set; throws std::runtime_error
+    // if it cannot be created
+    void initialize();
+
     void createProcess(const std::string &name);
+    // Creates count batch processes named p01, p02, ... taking the factory,
+    // table, state list and scheduler locks once each; returns how many
+    // were admitted
+    size_t createProcesses(size_t count);
     std::shared_ptr<Process> getProcess(const std::string &name);
-    void listProcesses();
+    // Running and finished processes, paged by offset and limit as one
+    // listing with the running processes first
+    void listProcesses(size_t offset = 0, size_t limit = SIZE_MAX);
     void startBatchProcessing();
     void stopBatchProcessing();
 
     void listProcessesWithMemory();
 
+    // Re-admits the processes recorded in a workload trace, with the same
+    // names, specs and cycle spacing, from the scheduler's arrival hook when
+    // it is single threaded or a background thread otherwise. Returns the
+    // number of admissions queued; throws std::runtime_error if the trace
+    // cannot be read or a replay is already running.
+    size_t replay(const std::string &path);
+    void stopReplay();
+
+    uint64_t getThrottledBatches() const { return throttledBatches.load(); }
+
 private:
-    ProcessManager() : nextPID(1), batchProcessingActive(false), lastProcessCreationCycle(0) {}
-    ~ProcessManager() { stopBatchProcessing(); }
+    ProcessManager() : nextPID(1), factory(nextPID), batchCounter(1), batchProcessingActive(false), replayActive(false),
+                       replayNext(0), replayStart(0), lastProcessCreationCycle(0), throttledBatches(0), lastArrivalCycle(0), lastTraceCycle(0) {}
+    // Runs during static destruction, possibly after the scheduler is gone,
+    // so it only ends the threads. The CLI stops generation and replay, and
+    // the scheduler drops its arrival hook, before either is destroyed.
+    ~ProcessManager()
+    {
+        batchProcessingActive = false;
+        replayActive = false;
+        if (batchProcessThread.joinable())
+        {
+            batchProcessThread.join();
+        }
+        if (replayThread.joinable())
+        {
+            replayThread.join();
+        }
+        factory.stop();
+    }
 
-    std::map<std::string, std::shared_ptr<Process>> processes;
+    ProcessStateLists stateLists; // Has its own lock, taken after processesMutex
+    ProcessTable processes;       // Guarded by processesMutex
     std::atomic<int> nextPID;
+    ProcessFactory factory;
+    std::atomic<int> batchCounter; // Next batch process name
     std::atomic<bool> batchProcessingActive;
     std::thread batchProcessThread;
+    std::atomic<bool> replayActive;
+    std::thread replayThread; // Started and joined under batchMutex
+    // Set under batchMutex while no replay is active, then used by one
+    // replay thread or arrival hook at a time
+    std::vector<WorkloadTrace::Admission> replayAdmissions;
+    size_t replayNext;
+    uint64_t replayStart; // Cycle the replay began
     std::mutex processesMutex;
     std::mutex batchMutex;
     uint64_t lastProcessCreationCycle;
+    std::atomic<uint64_t> throttledBatches; // Batch arrivals skipped while memory was overcommitted
+    std::unique_ptr<IArrivalModel> arrivalModel; // Used by one batch thread or arrival hook at a time
+    uint64_t lastArrivalCycle;
+
+    // Workload trace; traceMutex is a leaf
+    std::ofstream traceStream;
+    uint64_t lastTraceCycle; // Cycle of the last record written
+    std::mutex traceMutex;
 
+    size_t admitProcesses(std::vector<std::shared_ptr<Process>> batch, const std::vector<std::string> &names,
+                          bool fromFactory);
+    void recordAdmissions(const std::vector<std::shared_ptr<Process>> &admitted);
     void batchProcessingLoop();
+    // Returns the next cycle that may see arrivals
+    uint64_t admitArrivals(uint64_t currentCycle);
+    void replayLoop();
+    // Returns the cycle the next admission is due, or UINT64_MAX once the
+    // trace is done
+    uint64_t admitReplay(uint64_t currentCycle);
+    void updateArrivalHook();
+    void listSection(const char *title, const std::vector<std::shared_ptr<Process>> &page, size_t offset,
+                     size_t total, bool showMemory);
     std::string generateProcessName() const;
 };
 
@@ -0,0 +1,127 @@
+#include "ProcessStateLists.h"
+#include <algorithm>
+
+const int ProcessStateLists::STATE_COUNT;
+
+ProcessStateLists::ProcessStateLists()
+{
+    for (auto &list : lists)
+    {
+        list = {nullptr, nullptr, 0};
+    }
+}
+
+void ProcessStateLists::add(Process *process)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    link(process, process->hot.state.load());
+    process->cold->stateLists = this;
+}
+
+void ProcessStateLists::add(const std::vector<std::shared_ptr<Process>> &processes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &process : processes)
+    {
+        link(process.get(), process->hot.state.load());
+        process->cold->stateLists = this;
+    }
+}
+
+void ProcessStateLists::remove(Process *process)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (process->cold->stateLists != this)
+        return;
+
+    unlink(process, process->hot.state.load());
+    process->cold->stateLists = nullptr;
+}
+
+void ProcessStateLists::transition(Process *process, Process::ProcessState state)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Process::ProcessState previous = process->hot.state.load();
+    process->hot.state.store(state);
+    if (previous != state)
+    {
+        unlink(process, previous);
+        link(process, state);
+    }
+}
+
+size_t ProcessStateLists::count(Process::ProcessState state) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return lists[state].size;
+}
+
+std::vector<std::shared_ptr<Process>> ProcessStateLists::collect(Process::ProcessState state, size_t offset,
+                                                                 size_t limit, size_t &total) const
+{
+    std::vector<std::shared_ptr<Process>> result;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const List &list = lists[state];
+    total = list.size;
+    if (offset >= list.size)
+        return result;
+
+    result.reserve(std::min(limit, list.size - offset));
+    Process *process = list.head;
+    for (size_t skipped = 0; skipped < offset; ++skipped)
+    {
+        process = process->cold->stateNext;
+    }
+
+    // A linked process is still held by the process table, so taking a
+    // reference here is safe and keeps it alive once the lock is dropped
+    for (; process && result.size() < limit; process = process->cold->stateNext)
+    {
+        result.push_back(process->shared_from_this());
+    }
+    return result;
+}
+
+void ProcessStateLists::link(Process *process, Process::ProcessState state)
+{
+    List &list = lists[state];
+    process->cold->statePrev = list.tail;
+    process->cold->stateNext = nullptr;
+    if (list.tail)
+    {
+        list.tail->cold->stateNext = process;
+    }
+    else
+    {
+        list.head = process;
+    }
+    list.tail = process;
+    list.size++;
+}
+
+void ProcessStateLists::unlink(Process *process, Process::ProcessState state)
+{
+    List &list = lists[state];
+    Process *prev = process->cold->statePrev;
+    Process *next = process->cold->stateNext;
+    if (prev)
+    {
+        prev->cold->stateNext = next;
+    }
+    else
+    {
+        list.head = next;
+    }
+    if (next)
+    {
+        next->cold->statePrev = prev;
+    }
+    else
+    {
+        list.tail = prev;
+    }
+    process->cold->statePrev = nullptr;
+    process->cold->stateNext = nullptr;
+    list.size--;
+}
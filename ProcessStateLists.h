@@ -0,0 +1,57 @@
+#ifndef PROCESS_STATE_LISTS_H
+#define PROCESS_STATE_LISTS_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Process.h"
+
+// Processes linked into one intrusive list per state through links in the
+// process itself. A state change moves the process between lists in O(1),
+// so listing a state costs only the entries skipped and shown rather than
+// a walk over every process.
+class ProcessStateLists
+{
+public:
+    ProcessStateLists();
+
+    ProcessStateLists(const ProcessStateLists &) = delete;
+    ProcessStateLists &operator=(const ProcessStateLists &) = delete;
+
+    // Links a process under its current state; its later setState calls
+    // are routed here until it is removed
+    void add(Process *process);
+    void add(const std::vector<std::shared_ptr<Process>> &processes);
+    void remove(Process *process);
+
+    // Stores the new state and relinks the process under one lock, so the
+    // lists always agree with getState()
+    void transition(Process *process, Process::ProcessState state);
+
+    size_t count(Process::ProcessState state) const;
+
+    // Up to limit processes in the given state, skipping the first offset,
+    // oldest transition first. total receives the size of the whole list.
+    std::vector<std::shared_ptr<Process>> collect(Process::ProcessState state, size_t offset, size_t limit,
+                                                  size_t &total) const;
+
+private:
+    static const int STATE_COUNT = Process::FINISHED + 1;
+
+    struct List
+    {
+        Process *head;
+        Process *tail;
+        size_t size;
+    };
+
+    List lists[STATE_COUNT];
+    mutable std::mutex mutex;
+
+    // Callers hold the mutex
+    void link(Process *process, Process::ProcessState state);
+    void unlink(Process *process, Process::ProcessState state);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "ProcessTable.h"
+#include "Process.h"
+#include <functional>
+
+const uint32_t ProcessTable::EMPTY;
+const uint32_t ProcessTable::TOMBSTONE;
+const size_t ProcessTable::MIN_INDEX_SIZE;
+
+bool ProcessTable::insert(const std::shared_ptr<Process> &process, Handle &handle)
+{
+    uint32_t hash = hashName(process->getName());
+    if (findEntry(process->getName(), hash) != index.size())
+        return false;
+
+    // Keep live entries and tombstones under half the index
+    if ((liveCount + tombstones + 1) * 2 > index.size())
+    {
+        size_t newSize = MIN_INDEX_SIZE;
+        while (newSize < (liveCount + 1) * 4)
+        {
+            newSize *= 2;
+        }
+        rehash(newSize);
+    }
+
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back({nullptr, 0});
+    }
+    slots[slot].process = process;
+
+    size_t mask = index.size() - 1;
+    size_t pos = hash & mask;
+    while (index[pos].slot != EMPTY && index[pos].slot != TOMBSTONE)
+    {
+        pos = (pos + 1) & mask;
+    }
+    if (index[pos].slot == TOMBSTONE)
+    {
+        tombstones--;
+    }
+    index[pos] = {slot, hash};
+
+    liveCount++;
+    handle = {slot, slots[slot].generation};
+    return true;
+}
+
+void ProcessTable::remove(Handle handle)
+{
+    std::shared_ptr<Process> process = get(handle);
+    if (!process)
+        return;
+
+    const std::string &name = process->getName();
+    size_t pos = findEntry(name, hashName(name));
+    index[pos].slot = TOMBSTONE;
+    tombstones++;
+
+    Slot &slot = slots[handle.slot];
+    slot.process.reset();
+    slot.generation++;
+    freeSlots.push_back(handle.slot);
+    liveCount--;
+}
+
+std::shared_ptr<Process> ProcessTable::get(Handle handle) const
+{
+    if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation)
+        return nullptr;
+
+    return slots[handle.slot].process;
+}
+
+std::shared_ptr<Process> ProcessTable::find(const std::string &name) const
+{
+    size_t pos = findEntry(name, hashName(name));
+    if (pos == index.size())
+        return nullptr;
+
+    return slots[index[pos].slot].process;
+}
+
+uint32_t ProcessTable::hashName(const std::string &name)
+{
+    uint64_t hash = std::hash<std::string>()(name);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// Returns the index position holding name, or index.size() if absent
+size_t ProcessTable::findEntry(const std::string &name, uint32_t hash) const
+{
+    if (index.empty())
+        return index.size();
+
+    size_t mask = index.size() - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask)
+    {
+        const IndexEntry &entry = index[pos];
+        if (entry.slot == EMPTY)
+            return index.size();
+
+        if (entry.slot != TOMBSTONE && entry.hash == hash && slots[entry.slot].process->getName() == name)
+            return pos;
+    }
+}
+
+void ProcessTable::rehash(size_t newSize)
+{
+    std::vector<IndexEntry> old;
+    old.swap(index);
+    index.assign(newSize, {EMPTY, 0});
+    tombstones = 0;
+
+    size_t mask = newSize - 1;
+    for (const auto &entry : old)
+    {
+        if (entry.slot == EMPTY || entry.slot == TOMBSTONE)
+            continue;
+
+        size_t pos = entry.hash & mask;
+        while (index[pos].slot != EMPTY)
+        {
+            pos = (pos + 1) & mask;
+        }
+        index[pos] = entry;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Process;
+
+// Processes stored in a dense slot array with an open-addressing index
+// from name to slot. Removed slots are reused, and each reuse bumps the
+// slot's generation so handles to the old process are detected as stale.
+// Not synchronised; the ProcessManager locks around it.
+class ProcessTable
+{
+public:
+    struct Handle
+    {
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+    ProcessTable() : liveCount(0), tombstones(0) {}
+
+    // Adds a process under its name; false if the name is taken
+    bool insert(const std::shared_ptr<Process> &process, Handle &handle);
+    void remove(Handle handle);
+
+    // Null for a removed process or a stale handle
+    std::shared_ptr<Process> get(Handle handle) const;
+    std::shared_ptr<Process> find(const std::string &name) const;
+
+    size_t size() const { return liveCount; }
+
+    // Visits live processes in slot order, which is creation order until
+    // slots are reused
+    template <typename Visitor>
+    void forEach(Visitor visit) const
+    {
+        for (const auto &slot : slots)
+        {
+            if (slot.process)
+            {
+                visit(slot.process);
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::shared_ptr<Process> process;
+        uint32_t generation;
+    };
+
+    // Index entries keep the name hash so probing and rehashing rarely
+    // need to reach the process's name
+    struct IndexEntry
+    {
+        uint32_t slot;
+        uint32_t hash;
+    };
+
+    static const uint32_t EMPTY = UINT32_MAX;
+    static const uint32_t TOMBSTONE = UINT32_MAX - 1;
+    static const size_t MIN_INDEX_SIZE = 16;
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<IndexEntry> index; // Power-of-two size, linear probing
+    size_t liveCount;
+    size_t tombstones;
+
+    static uint32_t hashName(const std::string &name);
+    size_t findEntry(const std::string &name, uint32_t hash) const;
+    void rehash(size_t newSize);
+};
+
+#endif
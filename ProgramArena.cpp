@@ -0,0 +1,58 @@
+#include "ProgramArena.h"
+#include "SlabPool.h"
+#include <cstdint>
+
+const size_t ProgramArena::CHUNK_SIZE;
+
+void *ProgramArena::allocate(size_t size, size_t alignment)
+{
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    if (!cursor || aligned + size > reinterpret_cast<uintptr_t>(limit))
+    {
+        // Programs too large for a standard chunk get one of their own
+        size_t chunkSize = sizeof(Chunk) + alignment + size;
+        char *memory;
+        if (chunkSize <= CHUNK_SIZE)
+        {
+            chunkSize = CHUNK_SIZE;
+            memory = static_cast<char *>(SlabPool::get<CHUNK_SIZE, alignof(Chunk)>().allocate());
+        }
+        else
+        {
+            memory = static_cast<char *>(::operator new(chunkSize));
+        }
+
+        Chunk *chunk = reinterpret_cast<Chunk *>(memory);
+        chunk->next = chunks;
+        chunk->size = chunkSize;
+        chunks = chunk;
+        cursor = memory + sizeof(Chunk);
+        limit = memory + chunkSize;
+        aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    }
+
+    cursor = reinterpret_cast<char *>(aligned + size);
+    bytesUsed += size;
+    return reinterpret_cast<void *>(aligned);
+}
+
+void ProgramArena::release()
+{
+    while (chunks)
+    {
+        Chunk *next = chunks->next;
+        if (chunks->size == CHUNK_SIZE)
+        {
+            SlabPool::get<CHUNK_SIZE, alignof(Chunk)>().deallocate(chunks);
+        }
+        else
+        {
+            ::operator delete(chunks);
+        }
+        chunks = next;
+    }
+
+    cursor = nullptr;
+    limit = nullptr;
+    bytesUsed = 0;
+}
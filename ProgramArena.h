@@ -0,0 +1,55 @@
+#ifndef PROGRAM_ARENA_H
+#define PROGRAM_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Bump allocator holding one process's program: its commands and the
+// table pointing at them. Nothing is freed individually; release() hands
+// every chunk back at once. Standard-size chunks come from a shared slab
+// pool, so a program that fits in one chunk costs no malloc.
+class ProgramArena
+{
+public:
+    static const size_t CHUNK_SIZE = 4096;
+
+    ProgramArena() : chunks(nullptr), cursor(nullptr), limit(nullptr), bytesUsed(0) {}
+    ~ProgramArena() { release(); }
+
+    ProgramArena(const ProgramArena &) = delete;
+    ProgramArena &operator=(const ProgramArena &) = delete;
+
+    void *allocate(size_t size, size_t alignment);
+
+    template <typename T, typename... Args>
+    T *create(Args &&...args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T *allocateArray(size_t count)
+    {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Frees every chunk. Objects with destructors must be destroyed first.
+    void release();
+
+    size_t getBytesUsed() const { return bytesUsed; }
+
+private:
+    struct Chunk
+    {
+        Chunk *next;
+        size_t size; // Total bytes including this header
+    };
+
+    Chunk *chunks; // Newest first
+    char *cursor;
+    char *limit;
+    size_t bytesUsed;
+};
+
+#endif
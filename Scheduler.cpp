@@ -7,6 +7,7 @@
 #include <thread>
 #include <ctime>
 #include "Utils.h"
+#include "MemoryManager.h"
 
 Scheduler::Scheduler()
 {
@@ -25,6 +26,18 @@ void Scheduler::startScheduling()
     // Reset CPU cycles
     cpuCycles.store(0);
 
+    if (Config::getInstance().getEngine() == "event")
+    {
+        cpuThreads.emplace_back(&Scheduler::executeEvents, this);
+        return;
+    }
+
+    if (Config::getInstance().isDeterministic())
+    {
+        cpuThreads.emplace_back(&Scheduler::executeLockstep, this);
+        return;
+    }
+
     int numCPUs = Config::getInstance().getNumCPU();
     for (int i = 0; i < numCPUs; ++i)
     {
@@ -32,8 +45,17 @@ void Scheduler::startScheduling()
     }
 }
 
+// The hook captures its owner, which may be destroyed before the
+// scheduler, so it is dropped first. Taking arrivalMutex also waits out a
+// call already in progress.
 void Scheduler::stopScheduling()
 {
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        arrivalHook = nullptr;
+        arrivalHookChanged = false;
+    }
+
     processingActive = false;
     cv.notify_all();
     syncCv.notify_all();
@@ -59,13 +81,47 @@ void Scheduler::addProcess(std::shared_ptr<Process> process)
         return;
     }
 
-    readyQueue.push(process);
+    readyQueue.push_back(process);
     lock.unlock();
 
     cv.notify_all();
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
 }
 
+void Scheduler::addProcesses(const std::vector<std::shared_ptr<Process>> &processes)
+{
+    if (processes.empty())
+        return;
+
+    {
+        std::lock_guard<std::timed_mutex> lock(mutex);
+        readyQueue.insert(readyQueue.end(), processes.begin(), processes.end());
+    }
+    cv.notify_all();
+}
+
+void Scheduler::setArrivalHook(std::function<uint64_t(uint64_t)> hook)
+{
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        arrivalHook = std::move(hook);
+        arrivalHookChanged = true;
+    }
+    cv.notify_all();
+}
+
+uint64_t Scheduler::waitForCycle(uint64_t cycle, std::chrono::milliseconds timeout)
+{
+    // Registering before the check pairs with the clock bumping the cycle
+    // before it reads cycleWaiters, so no wakeup is lost
+    std::unique_lock<std::mutex> lock(cycleMutex);
+    cycleWaiters++;
+    cycleCv.wait_for(lock, timeout, [&]
+                     { return cpuCycles.load() > cycle; });
+    cycleWaiters--;
+    return cpuCycles.load();
+}
+
 void Scheduler::executeProcesses()
 {
     while (processingActive)
@@ -97,74 +153,346 @@ void Scheduler::executeProcesses()
 
         if (currentProcess)
         {
-            currentProcess->setState(Process::RUNNING);
-            int delays = Config::getInstance().getDelaysPerExec();
-            int currentDelay = 0;
+            CoreRun run;
+            beginRun(run, currentProcess);
+            while (processingActive && stepRun(run))
+            {
+                waitForCycleSync();
+            }
+            endRun(run);
+
+            cv.notify_all();
+        }
+        else
+        {
+            isActiveCycle = false;
+            waitForCycleSync();
+            cv.notify_all();
+        }
+    }
+}
+
+// One thread steps every core in core order, so dispatch, faults and
+// arrivals happen in the same order on every run whatever the host
+void Scheduler::executeLockstep()
+{
+    auto &memoryManager = MemoryManager::getInstance();
+    std::vector<CoreRun> runs(coreStatus.size());
 
-            while (!currentProcess->isFinished() && processingActive)
+    while (processingActive)
+    {
+        {
+            std::lock_guard<std::mutex> lock(arrivalMutex);
+            if (arrivalHook)
             {
-                isActiveCycle = true; // Mark as active cycle
+                arrivalHook(cpuCycles.load());
+            }
+        }
+
+        bool isActive = false;
+        for (size_t core = 0; core < runs.size(); ++core)
+        {
+            CoreRun &run = runs[core];
 
-                if (Config::getInstance().getSchedulerType() == "rr" &&
-                    currentProcess->getQuantumTime() >= Config::getInstance().getQuantumCycles())
+            // A run that ends without using the cycle frees the core for
+            // the next process straight away, as a core thread would
+            while (true)
+            {
+                if (!run.process)
                 {
-                    updateCoreStatus(currentProcess->getCPUCoreID(), false);
-                    handleQuantumExpiration(currentProcess);
-                    break;
+                    std::shared_ptr<Process> process;
+                    {
+                        std::lock_guard<std::timed_mutex> lock(mutex);
+                        process = getNextProcess(static_cast<int>(core));
+                    }
+                    if (!process)
+                        break;
+                    beginRun(run, process);
                 }
 
-                if (currentDelay < delays)
+                if (stepRun(run))
                 {
-                    currentDelay++;
+                    isActive = true;
+                    break;
                 }
-                else
-                {
-                    currentProcess->executeCurrentCommand(currentProcess->getCPUCoreID());
-                    currentProcess->moveToNextLine();
-                    currentDelay = 0;
+                endRun(run);
+                run.process.reset();
+            }
+        }
 
-                    if (Config::getInstance().getSchedulerType() == "rr")
-                    {
-                        currentProcess->incrementQuantumTime();
-                    }
-                }
+        memoryManager.drainPageIns();
 
-                waitForCycleSync();
+        isActiveCycle = isActive;
+        incrementCPUCycles();
+        if (isActive)
+        {
+            activeTicks++;
+        }
+        else
+        {
+            idleTicks++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(CYCLE_SPEED + CYCLE_WAIT));
+    }
+
+    // Settle processes still on a core as a core thread does when stopped
+    for (auto &run : runs)
+    {
+        if (run.process)
+        {
+            endRun(run);
+        }
+    }
+}
+
+// Discrete-event backend. One thread, as in lock-step mode, but the clock
+// jumps from one event to the next instead of ticking through cycles in
+// which no core changes state: between events a core is either idle or
+// counting down a delay. Arrivals and periodic work are kept as the next
+// cycle each is due rather than in the queue, since there is one of each.
+void Scheduler::executeEvents()
+{
+    auto &config = Config::getInstance();
+    auto &memoryManager = MemoryManager::getInstance();
+    std::vector<CoreRun> runs(coreStatus.size());
+    std::vector<bool> queued(runs.size(), false); // Core has an event in the queue
+    EventQueue queue;
+    uint64_t horizon = config.getEventHorizon();
+    uint64_t nextPeriodic = nextPeriodicCycle(cpuCycles.load());
+    uint64_t nextArrival = UINT64_MAX; // No hook set
+
+    while (processingActive)
+    {
+        uint64_t cycle = cpuCycles.load();
+        if (horizon > 0 && cycle >= horizon)
+        {
+            // The run is over; the clock stays put until the scheduler stops
+            std::unique_lock<std::timed_mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(100));
+            continue;
+        }
+
+        if (cycle >= nextPeriodic)
+        {
+            runPeriodicTasks(cycle);
+            nextPeriodic = nextPeriodicCycle(cycle);
+            events++;
+        }
+
+        // A newly set hook is called on the cycle it is noticed, since the
+        // cycle the old one asked for says nothing about the new one's
+        // sources. A hook with nothing left to admit returns UINT64_MAX and
+        // is not called again until it is replaced.
+        {
+            std::lock_guard<std::mutex> lock(arrivalMutex);
+            if (!arrivalHook)
+            {
+                nextArrival = UINT64_MAX;
+            }
+            else if (arrivalHookChanged || cycle >= nextArrival)
+            {
+                arrivalHookChanged = false;
+                nextArrival = std::max(cycle + 1, arrivalHook(cycle));
+                events++;
             }
+        }
 
+        // Processes made ready since the last event go to idle cores
+        bool hasReady;
+        {
+            std::lock_guard<std::timed_mutex> lock(mutex);
+            hasReady = !readyQueue.empty();
+        }
+        for (size_t core = 0; hasReady && core < runs.size(); ++core)
+        {
+            if (!runs[core].process && !queued[core])
             {
-                std::lock_guard<std::timed_mutex> lock(mutex);
-                if (currentProcess->isFinished())
-                {
-                    currentProcess->setState(Process::FINISHED);
-                    finishedProcesses.push_back(currentProcess);
-                    updateCoreStatus(currentProcess->getCPUCoreID(), false);
-                }
-                else if (Config::getInstance().getSchedulerType() != "rr")
-                {
-                    currentProcess->setState(Process::READY);
-                    readyQueue.push(currentProcess);
-                }
+                queue.push({cycle, static_cast<int>(core), DISPATCH});
+                queued[core] = true;
+            }
+        }
 
-                auto it = std::find(runningProcesses.begin(), runningProcesses.end(), currentProcess);
-                if (it != runningProcesses.end())
-                {
-                    runningProcesses.erase(it);
-                }
+        while (!queue.empty() && queue.top().cycle == cycle)
+        {
+            Event event = queue.top();
+            queue.pop();
+            queued[event.core] = handleCoreEvent(runs[event.core], event.core, cycle, queue);
+            events++;
+        }
+
+        memoryManager.drainPageIns();
+
+        // Periodic work is only worth reaching while something else is due
+        // or suspended processes are waiting on it to be resumed
+        uint64_t next = queue.empty() ? UINT64_MAX : queue.top().cycle;
+        next = std::min(next, nextArrival);
+        if (next != UINT64_MAX || getSuspendedCount() > 0)
+        {
+            next = std::min(next, nextPeriodic);
+        }
+
+        if (next == UINT64_MAX)
+        {
+            // Nothing will happen until a process or an arrival hook is added
+            std::unique_lock<std::timed_mutex> lock(mutex);
+            if (processingActive && readyQueue.empty())
+            {
+                cv.wait_for(lock, std::chrono::milliseconds(100));
             }
+            continue;
+        }
+        if (horizon > 0)
+        {
+            next = std::min(next, horizon);
+        }
 
-            cv.notify_all();
+        // Every cycle up to the next event counts as the cycle just run did
+        bool isActive = std::any_of(runs.begin(), runs.end(), [](const CoreRun &run)
+                                    { return run.process != nullptr; });
+        uint64_t span = next - cycle;
+        (isActive ? activeTicks : idleTicks) += span;
+        isActiveCycle = isActive;
+        skippedCycles += span - 1;
+        cpuCycles.store(next);
+        notifyCycleWaiters();
+    }
+
+    for (auto &run : runs)
+    {
+        if (run.process)
+        {
+            endRun(run);
         }
-        else
+    }
+}
+
+// Mirrors the lock-step inner loop for one core, except that a delay is
+// queued as the cycle the next line runs instead of being counted down
+bool Scheduler::handleCoreEvent(CoreRun &run, int core, uint64_t cycle, EventQueue &queue)
+{
+    auto &config = Config::getInstance();
+    int delays = static_cast<int>(config.getDelaysPerExec());
+    bool isRoundRobin = config.getSchedulerType() == "rr";
+
+    while (true)
+    {
+        if (!run.process)
         {
-            isActiveCycle = false;
-            waitForCycleSync();
-            cv.notify_all();
+            std::shared_ptr<Process> process;
+            {
+                std::lock_guard<std::timed_mutex> lock(mutex);
+                process = getNextProcess(core);
+            }
+            if (!process)
+                return false;
+            beginRun(run, process);
+        }
+
+        const std::shared_ptr<Process> &process = run.process;
+        if (run.currentDelay < delays && !process->isFinished() && !(isRoundRobin && isQuantumExpired(process)))
+        {
+            queue.push({cycle + static_cast<uint64_t>(delays - run.currentDelay), core, EXECUTE});
+            run.currentDelay = delays;
+            return true;
+        }
+
+        int line = process->getCommandCounter();
+        if (stepRun(run))
+        {
+            queue.push({cycle + 1, core, process->getCommandCounter() != line ? STEP : WAKEUP});
+            return true;
+        }
+        endRun(run);
+        run.process.reset();
+    }
+}
+
+void Scheduler::beginRun(CoreRun &run, const std::shared_ptr<Process> &process)
+{
+    run.process = process;
+    run.currentDelay = 0;
+    run.firstFetch = true;
+    process->setState(Process::RUNNING);
+    dispatches++;
+}
+
+bool Scheduler::stepRun(CoreRun &run)
+{
+    const std::shared_ptr<Process> &currentProcess = run.process;
+    if (currentProcess->isFinished())
+        return false;
+
+    isActiveCycle = true; // Mark as active cycle
+
+    if (Config::getInstance().getSchedulerType() == "rr" &&
+        currentProcess->getQuantumTime() >= Config::getInstance().getQuantumCycles())
+    {
+        std::lock_guard<std::timed_mutex> lock(mutex);
+        updateCoreStatus(currentProcess->getCPUCoreID(), false);
+        handleQuantumExpiration(currentProcess);
+        return false;
+    }
+
+    if (run.currentDelay < static_cast<int>(Config::getInstance().getDelaysPerExec()))
+    {
+        run.currentDelay++;
+    }
+    else if (currentProcess->executeCurrentCommand(currentProcess->getCPUCoreID()))
+    {
+        currentProcess->moveToNextLine();
+        run.firstFetch = false;
+
+        // Page table walks after TLB misses delay the next line
+        run.currentDelay = -static_cast<int>(
+            MemoryManager::getInstance().takeTranslationPenalty(currentProcess->getCPUCoreID()));
+
+        if (Config::getInstance().getSchedulerType() == "rr")
+        {
+            currentProcess->incrementQuantumTime();
+        }
+    }
+    else if (run.firstFetch)
+    {
+        // Page fault on the first fetch after dispatch; the line is retried next cycle
+        dispatchFaultStalls++;
+        run.firstFetch = false;
+    }
+    return true;
+}
+
+void Scheduler::endRun(CoreRun &run)
+{
+    const std::shared_ptr<Process> &currentProcess = run.process;
+    {
+        std::lock_guard<std::timed_mutex> lock(mutex);
+        if (currentProcess->isFinished())
+        {
+            currentProcess->setState(Process::FINISHED);
+            finishedProcesses.push_back(currentProcess);
+            updateCoreStatus(currentProcess->getCPUCoreID(), false);
+        }
+        else if (Config::getInstance().getSchedulerType() != "rr")
+        {
+            currentProcess->setState(Process::READY);
+            readyQueue.push_back(currentProcess);
+        }
+
+        auto it = std::find(runningProcesses.begin(), runningProcesses.end(), currentProcess);
+        if (it != runningProcesses.end())
+        {
+            runningProcesses.erase(it);
         }
     }
+
+    // Finished processes give their frames, swap slots and program back
+    if (currentProcess->getState() == Process::FINISHED)
+    {
+        MemoryManager::getInstance().deallocateMemory(currentProcess);
+        currentProcess->archive();
+    }
 }
 
-std::shared_ptr<Process> Scheduler::getNextProcess()
+std::shared_ptr<Process> Scheduler::getNextProcess(int core)
 {
     if (readyQueue.empty())
     {
@@ -172,12 +500,22 @@ std::shared_ptr<Process> Scheduler::getNextProcess()
     }
 
     int availableCore = -1;
-    for (size_t i = 0; i < coreStatus.size(); ++i)
+    if (core >= 0)
     {
-        if (!coreStatus[i])
+        if (!coreStatus[core])
         {
-            availableCore = static_cast<int>(i);
-            break;
+            availableCore = core;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < coreStatus.size(); ++i)
+        {
+            if (!coreStatus[i])
+            {
+                availableCore = static_cast<int>(i);
+                break;
+            }
         }
     }
 
@@ -200,12 +538,38 @@ std::shared_ptr<Process> Scheduler::getNextProcess()
     {
         nextProcess->setCPUCoreID(availableCore);
         coreStatus[availableCore] = true;
+        MemoryManager::getInstance().switchContext(availableCore, nextProcess->getPID());
         runningProcesses.push_back(nextProcess);
+        prefetchUpcoming();
     }
 
     return nextProcess;
 }
 
+void Scheduler::prefetchUpcoming()
+{
+    // Warm the pages the next processes in line will fetch and write during
+    // their first quantum
+    size_t depth = std::min<size_t>(Config::getInstance().getPrefetchDepth(), readyQueue.size());
+    int window = static_cast<int>(Config::getInstance().getQuantumCycles());
+
+    for (size_t i = 0; i < depth; ++i)
+    {
+        const auto &process = readyQueue[i];
+        int firstLine = process->getCommandCounter();
+        int lastLine = std::min(firstLine + window, process->getLinesOfCode()) - 1;
+        if (lastLine < firstLine)
+            continue;
+
+        MemoryManager::getInstance().prefetch(process->getPID(),
+                                              process->getInstructionAddress(firstLine),
+                                              process->getInstructionAddress(lastLine));
+        MemoryManager::getInstance().prefetch(process->getPID(),
+                                              process->getDataAddress(firstLine),
+                                              process->getDataAddress(lastLine), true);
+    }
+}
+
 std::shared_ptr<Process> Scheduler::fcfsSchedule()
 {
     if (readyQueue.empty())
@@ -214,7 +578,7 @@ std::shared_ptr<Process> Scheduler::fcfsSchedule()
     }
 
     auto process = readyQueue.front();
-    readyQueue.pop();
+    readyQueue.pop_front();
     return process;
 }
 
@@ -224,7 +588,7 @@ std::shared_ptr<Process> Scheduler::roundRobinSchedule()
         return nullptr;
 
     auto process = readyQueue.front();
-    readyQueue.pop();
+    readyQueue.pop_front();
 
     if (isQuantumExpired(process))
     {
@@ -233,7 +597,7 @@ std::shared_ptr<Process> Scheduler::roundRobinSchedule()
         if (!readyQueue.empty())
         {
             process = readyQueue.front();
-            readyQueue.pop();
+            readyQueue.pop_front();
         }
         else
         {
@@ -253,7 +617,108 @@ void Scheduler::handleQuantumExpiration(std::shared_ptr<Process> process)
 {
     process->resetQuantumTime();
     process->setState(Process::READY);
-    readyQueue.push(process);
+    readyQueue.push_back(process);
+}
+
+void Scheduler::incrementCPUCycles()
+{
+    uint64_t cycle = ++cpuCycles;
+    notifyCycleWaiters();
+    runPeriodicTasks(cycle);
+}
+
+void Scheduler::notifyCycleWaiters()
+{
+    if (cycleWaiters.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(cycleMutex);
+        cycleCv.notify_all();
+    }
+}
+
+void Scheduler::runPeriodicTasks(uint64_t cycle)
+{
+    auto &config = Config::getInstance();
+
+    // Snapshots are taken at quantum boundaries so they line up with preemption
+    uint64_t snapshotCycles = static_cast<uint64_t>(config.getSnapshotInterval()) * config.getQuantumCycles();
+    if (snapshotCycles > 0 && cycle % snapshotCycles == 0)
+    {
+        MemoryManager::getInstance().requestSnapshot(cycle);
+    }
+
+    uint32_t window = config.getWorkingSetWindow();
+    if (window > 0 && cycle % window == 0)
+    {
+        MemoryManager::getInstance().sampleWorkingSets();
+        controlLoad();
+    }
+}
+
+uint64_t Scheduler::nextPeriodicCycle(uint64_t after) const
+{
+    auto &config = Config::getInstance();
+    uint64_t next = UINT64_MAX;
+
+    uint64_t snapshotCycles = static_cast<uint64_t>(config.getSnapshotInterval()) * config.getQuantumCycles();
+    if (snapshotCycles > 0)
+    {
+        next = std::min(next, (after / snapshotCycles + 1) * snapshotCycles);
+    }
+
+    uint64_t window = config.getWorkingSetWindow();
+    if (window > 0)
+    {
+        next = std::min(next, (after / window + 1) * window);
+    }
+    return next;
+}
+
+void Scheduler::controlLoad()
+{
+    auto &memoryManager = MemoryManager::getInstance();
+    size_t capacity = memoryManager.getFrameCapacity();
+    if (capacity == 0)
+        return;
+
+    size_t demand = memoryManager.getWorkingSetDemand();
+    std::lock_guard<std::timed_mutex> lock(mutex);
+
+    // One change per window, so every step is measured before the next
+    if (demand > capacity)
+    {
+        // Suspend the newest ready process rather than let every process
+        // fault; its frames age out while it sits idle
+        if (readyQueue.empty() || readyQueue.size() + runningProcesses.size() < 2)
+            return;
+
+        auto newest = std::max_element(readyQueue.begin(), readyQueue.end(),
+                                       [](const std::shared_ptr<Process> &a, const std::shared_ptr<Process> &b)
+                                       { return a->getPID() < b->getPID(); });
+        std::shared_ptr<Process> process = *newest;
+        readyQueue.erase(newest);
+
+        process->setState(Process::WAITING);
+        suspendedProcesses.push_back({process, memoryManager.getWorkingSet(process->getPID())});
+        suspensions++;
+    }
+    else if (!suspendedProcesses.empty())
+    {
+        // Resume the oldest suspended process once its working set fits, or
+        // unconditionally when nothing else is left to run
+        auto oldest = std::min_element(suspendedProcesses.begin(), suspendedProcesses.end(),
+                                       [](const SuspendedProcess &a, const SuspendedProcess &b)
+                                       { return a.process->getPID() < b.process->getPID(); });
+        bool isIdle = readyQueue.empty() && runningProcesses.empty();
+        if (!isIdle && demand + oldest->workingSet > capacity)
+            return;
+
+        oldest->process->setState(Process::READY);
+        readyQueue.push_back(oldest->process);
+        suspendedProcesses.erase(oldest);
+        resumes++;
+        cv.notify_all();
+    }
 }
 
 void Scheduler::getCPUUtilization() const
@@ -305,10 +770,11 @@ void Scheduler::getCPUUtilization() const
     }
 }
 
+const int Scheduler::CYCLE_SPEED;
+const int Scheduler::CYCLE_WAIT;
+
 void Scheduler::waitForCycleSync()
 {
-    const int CYCLE_SPEED = 1000; // Base timing in microseconds
-    const int CYCLE_WAIT = 999;
 
     try
     {
@@ -1,6 +1,9 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <queue>
 #include <thread>
 #include <memory>
@@ -24,15 +27,43 @@ public:
     Scheduler &operator=(const Scheduler &) = delete;
 
     void addProcess(std::shared_ptr<Process> process);
+    void addProcesses(const std::vector<std::shared_ptr<Process>> &processes);
     void startScheduling();
     void stopScheduling();
     void getCPUUtilization() const;
     uint64_t getCPUCycles() const { return cpuCycles.load(); }
 
+    // Blocks until the clock has moved past the given cycle or the timeout
+    // expires, and returns the current cycle
+    uint64_t waitForCycle(uint64_t cycle, std::chrono::milliseconds timeout);
+
+    // Single-threaded schedulers only: called on the scheduler thread at the
+    // start of a cycle, before dispatch, to admit that cycle's arrivals. It
+    // returns the next cycle it needs, or UINT64_MAX for none; the lock-step
+    // thread calls it every cycle anyway, the event engine only then and on
+    // the cycle after it is set. Clearing it waits for a call in progress.
+    void setArrivalHook(std::function<uint64_t(uint64_t)> hook);
+
     uint64_t getIdleTicks() const { return idleTicks.load(); }
     uint64_t getActiveTicks() const { return activeTicks.load(); }
     uint64_t getTotalTicks() const { return cpuCycles.load(); }
 
+    // Event engine statistics
+    uint64_t getEvents() const { return events.load(); }
+    uint64_t getSkippedCycles() const { return skippedCycles.load(); }
+
+    uint64_t getDispatches() const { return dispatches.load(); }
+    uint64_t getDispatchFaultStalls() const { return dispatchFaultStalls.load(); }
+
+    // Load control statistics
+    size_t getSuspendedCount() const
+    {
+        std::lock_guard<std::timed_mutex> lock(mutex);
+        return suspendedProcesses.size();
+    }
+    uint64_t getSuspensions() const { return suspensions.load(); }
+    uint64_t getResumes() const { return resumes.load(); }
+
     std::vector<std::shared_ptr<Process>> getRunningProcesses() const
     {
         std::lock_guard<std::timed_mutex> lock(mutex);
@@ -46,10 +77,19 @@ private:
     std::atomic<bool> isInitialized{false};
 
     // Process queues
-    std::queue<std::shared_ptr<Process>> readyQueue;
+    std::deque<std::shared_ptr<Process>> readyQueue;
     std::vector<std::shared_ptr<Process>> runningProcesses;
     std::vector<std::shared_ptr<Process>> finishedProcesses;
 
+    // Held out of the ready queue while memory is overcommitted, with the
+    // working set each had when suspended
+    struct SuspendedProcess
+    {
+        std::shared_ptr<Process> process;
+        size_t workingSet;
+    };
+    std::deque<SuspendedProcess> suspendedProcesses;
+
     // Synchronization with timed mutexes
     mutable std::timed_mutex mutex;
     mutable std::timed_mutex syncMutex;
@@ -64,19 +104,86 @@ private:
     std::atomic<uint64_t> cpuCycles{0};
     std::atomic<bool> isActiveCycle{false};
 
+    // Cycle events; the clock only takes cycleMutex while someone is waiting
+    std::mutex cycleMutex;
+    std::condition_variable cycleCv;
+    std::atomic<int> cycleWaiters{0};
+
+    static const int CYCLE_SPEED = 1000; // Base timing in microseconds
+    static const int CYCLE_WAIT = 999;
+
+    // A process's stay on one core, stepped a cycle at a time
+    struct CoreRun
+    {
+        std::shared_ptr<Process> process;
+        int currentDelay;
+        bool firstFetch;
+    };
+
+    std::mutex arrivalMutex;
+    std::function<uint64_t(uint64_t)> arrivalHook; // Guarded by arrivalMutex
+    bool arrivalHookChanged{false};                // Set with the hook, cleared once the event engine calls it
+
+    // Something the event engine must do for a core. Events are taken in
+    // cycle order, and in core order within a cycle as the lock-step thread
+    // steps the cores.
+    enum EventType
+    {
+        DISPATCH, // Idle core picks up a ready process
+        STEP,     // Cycle after a line ran: completion, quantum expiry or the next delay
+        EXECUTE,  // Delay over, the next line runs
+        WAKEUP    // Retry of a line that faulted, its page-in now done
+    };
+    struct Event
+    {
+        uint64_t cycle;
+        int core;
+        EventType type;
+
+        bool operator>(const Event &other) const
+        {
+            return cycle != other.cycle ? cycle > other.cycle : core > other.core;
+        }
+    };
+    typedef std::priority_queue<Event, std::vector<Event>, std::greater<Event>> EventQueue;
+
     // Core methods
     void executeProcesses();
-    std::shared_ptr<Process> getNextProcess();
+    void executeLockstep();
+    void executeEvents();
+    // Runs the core's part of the cycle and queues its next event; false
+    // once the core is idle
+    bool handleCoreEvent(CoreRun &run, int core, uint64_t cycle, EventQueue &queue);
+    void beginRun(CoreRun &run, const std::shared_ptr<Process> &process);
+    // Runs one cycle; false once the process has finished or been preempted
+    bool stepRun(CoreRun &run);
+    void endRun(CoreRun &run);
+    // Picks the first free core, or only the given core when one is named
+    std::shared_ptr<Process> getNextProcess(int core = -1);
     std::shared_ptr<Process> roundRobinSchedule();
     std::shared_ptr<Process> fcfsSchedule();
+    void prefetchUpcoming();
     void handleQuantumExpiration(std::shared_ptr<Process> process);
     bool isQuantumExpired(const std::shared_ptr<Process> &process) const;
     void updateCoreStatus(int coreID, bool active);
-    void incrementCPUCycles() { ++cpuCycles; }
+    void incrementCPUCycles();
+    void notifyCycleWaiters();
+    void runPeriodicTasks(uint64_t cycle);
+    // First cycle after the given one with periodic work, UINT64_MAX if none
+    uint64_t nextPeriodicCycle(uint64_t after) const;
+    void controlLoad();
     void waitForCycleSync();
 
     std::atomic<uint64_t> idleTicks{0};
     std::atomic<uint64_t> activeTicks{0};
+
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> skippedCycles{0};
+
+    std::atomic<uint64_t> dispatches{0};
+    std::atomic<uint64_t> dispatchFaultStalls{0};
+    std::atomic<uint64_t> suspensions{0};
+    std::atomic<uint64_t> resumes{0};
 };
 
 #endif
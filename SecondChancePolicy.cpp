@@ -0,0 +1,27 @@
+#include "SecondChancePolicy.h"
+#include "FrameTable.h"
+
+SecondChancePolicy::SecondChancePolicy(size_t numFrames)
+    : FIFOPolicy(numFrames, SECOND_CHANCE)
+{
+}
+
+bool SecondChancePolicy::selectVictim(FrameTable &frameTable, uint32_t &victim)
+{
+    // Every frame is requeued at most once, so two passes always find a victim
+    size_t remaining = 2 * frameTable.size();
+    while (head != NIL && remaining-- > 0)
+    {
+        uint32_t frame = head;
+        if (!frameTable.testAndClear(frame, FrameTable::REFERENCED))
+        {
+            victim = frame;
+            return true;
+        }
+
+        unlink(frame);
+        pushBack(frame);
+    }
+
+    return FIFOPolicy::selectVictim(frameTable, victim);
+}
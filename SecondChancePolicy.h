@@ -0,0 +1,16 @@
+#ifndef SECOND_CHANCE_POLICY_H
+#define SECOND_CHANCE_POLICY_H
+
+#include "FIFOPolicy.h"
+
+// FIFO that requeues a referenced head frame once before evicting it
+class SecondChancePolicy : public FIFOPolicy
+{
+public:
+    SecondChancePolicy(size_t numFrames);
+
+    bool selectVictim(FrameTable &frameTable, uint32_t &victim) override;
+    std::string getName() const override { return "second-chance"; }
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "SegregatedFitAllocator.h"
+
+SegregatedFitAllocator::SegregatedFitAllocator(size_t totalSize)
+    : IFlatAllocator(SEGREGATED_FIT, totalSize)
+{
+    insertFree(0, totalSize);
+}
+
+bool SegregatedFitAllocator::allocate(size_t size, size_t &address, size_t &blockSize)
+{
+    auto sizeClass = freeBySize.lower_bound(size);
+    if (sizeClass == freeBySize.end())
+        return false;
+
+    size_t available = sizeClass->first;
+    size_t block = *sizeClass->second.begin();
+    removeFree(block, available);
+
+    if (available > size)
+    {
+        insertFree(block + size, available - size);
+    }
+
+    allocatedBlocks[block] = size;
+    address = block;
+    blockSize = size;
+    return true;
+}
+
+void SegregatedFitAllocator::release(size_t address)
+{
+    auto it = allocatedBlocks.find(address);
+    if (it == allocatedBlocks.end())
+        return;
+
+    size_t size = it->second;
+    allocatedBlocks.erase(it);
+
+    auto next = freeByAddress.lower_bound(address);
+    if (next != freeByAddress.end() && next->first == address + size)
+    {
+        size += next->second;
+        removeFree(next->first, next->second);
+    }
+
+    auto prev = freeByAddress.lower_bound(address);
+    if (prev != freeByAddress.begin())
+    {
+        --prev;
+        if (prev->first + prev->second == address)
+        {
+            address = prev->first;
+            size += prev->second;
+            removeFree(prev->first, prev->second);
+        }
+    }
+
+    insertFree(address, size);
+}
+
+void SegregatedFitAllocator::getBlocks(std::vector<FlatBlock> &blocks) const
+{
+    // Merge the two address-ordered maps
+    blocks.clear();
+    auto freeIt = freeByAddress.begin();
+    auto liveIt = allocatedBlocks.begin();
+    while (freeIt != freeByAddress.end() || liveIt != allocatedBlocks.end())
+    {
+        if (liveIt == allocatedBlocks.end() || (freeIt != freeByAddress.end() && freeIt->first < liveIt->first))
+        {
+            blocks.push_back({freeIt->first, freeIt->second, true});
+            ++freeIt;
+        }
+        else
+        {
+            blocks.push_back({liveIt->first, liveIt->second, false});
+            ++liveIt;
+        }
+    }
+}
+
+size_t SegregatedFitAllocator::getLargestFreeBlock() const
+{
+    return freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+}
+
+size_t SegregatedFitAllocator::compact(std::vector<std::pair<size_t, size_t>> &relocations)
+{
+    std::map<size_t, size_t> compacted;
+    size_t cursor = 0;
+    size_t moved = 0;
+
+    for (const auto &block : allocatedBlocks)
+    {
+        if (block.first != cursor)
+        {
+            relocations.push_back(std::make_pair(block.first, cursor));
+            moved += block.second;
+        }
+        compacted[cursor] = block.second;
+        cursor += block.second;
+    }
+
+    allocatedBlocks.swap(compacted);
+    freeBySize.clear();
+    freeByAddress.clear();
+    if (cursor < totalSize)
+    {
+        insertFree(cursor, totalSize - cursor);
+    }
+    return moved;
+}
+
+void SegregatedFitAllocator::insertFree(size_t address, size_t size)
+{
+    freeBySize[size].insert(address);
+    freeByAddress[address] = size;
+}
+
+void SegregatedFitAllocator::removeFree(size_t address, size_t size)
+{
+    auto sizeClass = freeBySize.find(size);
+    if (sizeClass != freeBySize.end())
+    {
+        sizeClass->second.erase(address);
+        if (sizeClass->second.empty())
+        {
+            freeBySize.erase(sizeClass);
+        }
+    }
+    freeByAddress.erase(address);
+}
@@ -0,0 +1,34 @@
+#ifndef SEGREGATED_FIT_ALLOCATOR_H
+#define SEGREGATED_FIT_ALLOCATOR_H
+
+#include "IFlatAllocator.h"
+#include <map>
+#include <set>
+
+// Best fit over free blocks indexed by size, ties broken by lowest address
+class SegregatedFitAllocator : public IFlatAllocator
+{
+public:
+    SegregatedFitAllocator(size_t totalSize);
+
+    bool allocate(size_t size, size_t &address, size_t &blockSize) override;
+    void release(size_t address) override;
+    std::string getName() const override { return "segregated"; }
+
+    size_t getFreeBlockCount() const override { return freeByAddress.size(); }
+    size_t getLargestFreeBlock() const override;
+    void getBlocks(std::vector<FlatBlock> &blocks) const override;
+
+    bool canCompact() const override { return true; }
+    size_t compact(std::vector<std::pair<size_t, size_t>> &relocations) override;
+
+private:
+    std::map<size_t, std::set<size_t>> freeBySize; // Size class to free block addresses
+    std::map<size_t, size_t> freeByAddress;        // Free block address to size, for coalescing
+    std::map<size_t, size_t> allocatedBlocks;      // Live block address to size
+
+    void insertFree(size_t address, size_t size);
+    void removeFree(size_t address, size_t size);
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "SlabPool.h"
+#include <algorithm>
+
+const size_t SlabPool::OBJECTS_PER_SLAB;
+
+SlabPool::SlabPool(size_t size, size_t alignment) : freeList(nullptr)
+{
+    // Every block must hold a free list link and keep the next block aligned
+    alignment = std::max(alignment, alignof(FreeBlock));
+    blockSize = (std::max(size, sizeof(FreeBlock)) + alignment - 1) / alignment * alignment;
+}
+
+void *SlabPool::allocate()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!freeList)
+    {
+        grow();
+    }
+
+    FreeBlock *block = freeList;
+    freeList = block->next;
+    return block;
+}
+
+void SlabPool::deallocate(void *block)
+{
+    if (!block)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    FreeBlock *freed = static_cast<FreeBlock *>(block);
+    freed->next = freeList;
+    freeList = freed;
+}
+
+size_t SlabPool::getSlabCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return slabs.size();
+}
+
+// Caller holds the mutex. Blocks are linked in address order so consecutive
+// allocations are adjacent in memory.
+void SlabPool::grow()
+{
+    char *slab = static_cast<char *>(::operator new(blockSize * OBJECTS_PER_SLAB));
+    slabs.push_back(slab);
+
+    for (size_t i = OBJECTS_PER_SLAB; i > 0; --i)
+    {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + (i - 1) * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+}
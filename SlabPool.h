@@ -0,0 +1,88 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Pool of fixed-size blocks carved from slabs of OBJECTS_PER_SLAB blocks.
+// Freed blocks go on a free list and slabs are kept until exit, so once
+// the pool has reached its high-water mark allocation never calls malloc.
+// There is one pool per block size and alignment, shared by every type of
+// that size.
+class SlabPool
+{
+public:
+    static const size_t OBJECTS_PER_SLAB = 64;
+
+    // Pools are never destroyed, so singletons that release objects during
+    // static destruction still have somewhere to return them
+    template <size_t Size, size_t Alignment>
+    static SlabPool &get()
+    {
+        static SlabPool *pool = new SlabPool(Size, Alignment);
+        return *pool;
+    }
+
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    void *allocate();
+    void deallocate(void *block);
+
+    size_t getBlockSize() const { return blockSize; }
+    size_t getSlabCount() const;
+
+private:
+    SlabPool(size_t size, size_t alignment);
+
+    // Free blocks are linked through their first bytes
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    size_t blockSize;
+    FreeBlock *freeList;
+    std::vector<void *> slabs;
+    mutable std::mutex mutex;
+
+    void grow();
+};
+
+// Standard allocator that serves single objects from the SlabPool for
+// their size, for use with std::allocate_shared and containers of nodes.
+// Array requests fall through to operator new.
+template <typename T>
+class SlabAllocator
+{
+public:
+    typedef T value_type;
+
+    SlabAllocator() {}
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U> &) {}
+
+    T *allocate(size_t count)
+    {
+        if (count == 1)
+            return static_cast<T *>(SlabPool::get<sizeof(T), alignof(T)>().allocate());
+        return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T *object, size_t count)
+    {
+        if (count == 1)
+            SlabPool::get<sizeof(T), alignof(T)>().deallocate(object);
+        else
+            ::operator delete(object);
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const SlabAllocator<U> &) const { return false; }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "SwapStore.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const uint32_t SwapStore::INVALID_SLOT;
+
+SwapStore::SwapStore()
+    : slotSize(0),
+      numSlots(0),
+      mapping(nullptr),
+#ifdef _WIN32
+      fileHandle(INVALID_HANDLE_VALUE),
+      mappingHandle(nullptr),
+#else
+      fileDescriptor(-1),
+#endif
+      reads(0),
+      writes(0),
+      fullFailures(0)
+{
+}
+
+void SwapStore::open(const std::string &filePath, size_t slotBytes, size_t slotCount)
+{
+    close();
+
+    path = filePath;
+    slotSize = slotBytes;
+    numSlots = slotCount;
+    uint64_t fileSize = static_cast<uint64_t>(slotSize) * numSlots;
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                             CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        throw SwapException("Could not create swap file: " + path);
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(fileSize >> 32),
+                                       static_cast<DWORD>(fileSize & 0xFFFFFFFF), nullptr);
+    if (mappingHandle == nullptr)
+    {
+        close();
+        throw SwapException("Could not map swap file: " + path);
+    }
+
+    mapping = static_cast<char *>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+#else
+    fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fileDescriptor < 0)
+    {
+        throw SwapException("Could not create swap file: " + path);
+    }
+
+    // Reserve the blocks now rather than leaving a sparse file: a write
+    // through the mapping into a hole the disk can't fill raises SIGBUS
+    int error = posix_fallocate(fileDescriptor, 0, static_cast<off_t>(fileSize));
+    if (error != 0)
+    {
+        close();
+        throw SwapException("Could not preallocate swap file: " + path + " (" + std::strerror(error) + ")");
+    }
+
+    void *view = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    mapping = (view == MAP_FAILED) ? nullptr : static_cast<char *>(view);
+#endif
+
+    if (mapping == nullptr)
+    {
+        close();
+        throw SwapException("Could not map swap file: " + path);
+    }
+
+    // Hand out low slots first so the file is used front to back
+    freeSlots.clear();
+    freeSlots.reserve(numSlots);
+    for (size_t i = numSlots; i > 0; --i)
+    {
+        freeSlots.push_back(static_cast<uint32_t>(i - 1));
+    }
+
+    reads = 0;
+    writes = 0;
+    fullFailures = 0;
+    readLatency.reset();
+    writeLatency.reset();
+}
+
+void SwapStore::close()
+{
+#ifdef _WIN32
+    if (mapping != nullptr)
+    {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle != nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+        std::remove(path.c_str());
+    }
+#else
+    if (mapping != nullptr)
+    {
+        munmap(mapping, slotSize * numSlots);
+    }
+    if (fileDescriptor >= 0)
+    {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+        std::remove(path.c_str());
+    }
+#endif
+    mapping = nullptr;
+    freeSlots.clear();
+}
+
+bool SwapStore::allocateSlot(uint32_t &slot)
+{
+    std::lock_guard<std::mutex> lock(slotMutex);
+
+    if (freeSlots.empty())
+    {
+        ++fullFailures;
+        return false;
+    }
+
+    slot = freeSlots.back();
+    freeSlots.pop_back();
+    return true;
+}
+
+void SwapStore::freeSlot(uint32_t slot)
+{
+    if (slot != INVALID_SLOT && slot < numSlots)
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        freeSlots.push_back(slot);
+    }
+}
+
+void SwapStore::writeSlot(uint32_t slot, const char *data)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::memcpy(mapping + static_cast<size_t>(slot) * slotSize, data, slotSize);
+    writeLatency.record(std::chrono::steady_clock::now() - start);
+    ++writes;
+}
+
+void SwapStore::readSlot(uint32_t slot, char *data)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::memcpy(data, mapping + static_cast<size_t>(slot) * slotSize, slotSize);
+    readLatency.record(std::chrono::steady_clock::now() - start);
+    ++reads;
+}
+
+size_t SwapStore::getUsedSlots() const
+{
+    std::lock_guard<std::mutex> lock(slotMutex);
+    return numSlots - freeSlots.size();
+}
@@ -0,0 +1,76 @@
+#ifndef SWAP_STORE_H
+#define SWAP_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LatencyHistogram.h"
+
+// Preallocated, memory-mapped backing file divided into page-sized slots
+class SwapStore
+{
+public:
+    static const uint32_t INVALID_SLOT = UINT32_MAX;
+
+    SwapStore();
+    ~SwapStore() { close(); }
+
+    SwapStore(const SwapStore &) = delete;
+    SwapStore &operator=(const SwapStore &) = delete;
+
+    void open(const std::string &path, size_t slotSize, size_t numSlots);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+
+    // Slot allocation
+    bool allocateSlot(uint32_t &slot);
+    void freeSlot(uint32_t slot);
+
+    // Page transfer between a frame and a slot
+    void writeSlot(uint32_t slot, const char *data);
+    void readSlot(uint32_t slot, char *data);
+
+    // Statistics for vmstat
+    size_t getNumSlots() const { return numSlots; }
+    size_t getUsedSlots() const;
+    uint64_t getReads() const { return reads; }
+    uint64_t getWrites() const { return writes; }
+    uint64_t getFullFailures() const { return fullFailures; }
+    const LatencyHistogram &getReadLatency() const { return readLatency; }
+    const LatencyHistogram &getWriteLatency() const { return writeLatency; }
+
+    class SwapException : public std::runtime_error
+    {
+    public:
+        SwapException(const std::string &msg) : std::runtime_error(msg) {}
+    };
+
+private:
+    std::string path;
+    size_t slotSize;
+    size_t numSlots;
+    char *mapping;
+
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    // LIFO free list; slots are freed by the scheduler and taken by the I/O thread
+    mutable std::mutex slotMutex;
+    std::vector<uint32_t> freeSlots;
+
+    // Updated by the I/O thread without any lock
+    std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> writes;
+    std::atomic<uint64_t> fullFailures;
+    LatencyHistogram readLatency;
+    LatencyHistogram writeLatency;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "TLB.h"
+
+TLB::TLB() : useClock(0), currentASID(UINT32_MAX), hits(0), misses(0), shootdowns(0), switches(0)
+{
+    flush();
+}
+
+bool TLB::lookup(uint32_t asid, uint32_t virtualPage, bool isWrite, uint32_t &frame)
+{
+    Entry *set = entries[setIndex(asid, virtualPage)];
+    for (size_t way = 0; way < WAYS; ++way)
+    {
+        Entry &entry = set[way];
+        if (entry.isValid && entry.asid == asid && entry.virtualPage == virtualPage &&
+            (entry.isWritable || !isWrite))
+        {
+            entry.lastUse = ++useClock;
+            frame = entry.frame;
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void TLB::insert(uint32_t asid, uint32_t virtualPage, uint32_t frame, bool isWritable)
+{
+    // Refill an existing entry, else take a free way or the least recently used
+    Entry *set = entries[setIndex(asid, virtualPage)];
+    Entry *target = &set[0];
+    for (size_t way = 0; way < WAYS; ++way)
+    {
+        Entry &entry = set[way];
+        if (entry.isValid && entry.asid == asid && entry.virtualPage == virtualPage)
+        {
+            target = &entry;
+            break;
+        }
+        if (!entry.isValid)
+        {
+            if (target->isValid)
+                target = &entry;
+        }
+        else if (target->isValid && entry.lastUse < target->lastUse)
+        {
+            target = &entry;
+        }
+    }
+
+    target->asid = asid;
+    target->virtualPage = virtualPage;
+    target->frame = frame;
+    target->isValid = true;
+    target->isWritable = isWritable;
+    target->lastUse = ++useClock;
+}
+
+bool TLB::invalidate(uint32_t asid, uint32_t virtualPage)
+{
+    Entry *set = entries[setIndex(asid, virtualPage)];
+    for (size_t way = 0; way < WAYS; ++way)
+    {
+        Entry &entry = set[way];
+        if (entry.isValid && entry.asid == asid && entry.virtualPage == virtualPage)
+        {
+            entry.isValid = false;
+            shootdowns.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TLB::flush()
+{
+    for (size_t set = 0; set < SETS; ++set)
+    {
+        for (size_t way = 0; way < WAYS; ++way)
+        {
+            entries[set][way].isValid = false;
+            entries[set][way].lastUse = 0;
+        }
+    }
+}
+
+void TLB::switchTo(uint32_t asid)
+{
+    if (asid != currentASID)
+    {
+        currentASID = asid;
+        switches.fetch_add(1, std::memory_order_relaxed);
+    }
+}
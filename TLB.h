@@ -0,0 +1,60 @@
+#ifndef TLB_H
+#define TLB_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Set-associative translation cache for one core. Entries are tagged with
+// the owning PID, so a context switch does not need to flush them.
+// Not synchronised; the MemoryManager locks each core's TLB.
+class TLB
+{
+public:
+    static const size_t SETS = 16;
+    static const size_t WAYS = 4;
+
+    TLB();
+
+    // A write through a read-only entry misses so the walk can break sharing
+    bool lookup(uint32_t asid, uint32_t virtualPage, bool isWrite, uint32_t &frame);
+    void insert(uint32_t asid, uint32_t virtualPage, uint32_t frame, bool isWritable);
+
+    // Drops one translation after its page table entry changed
+    bool invalidate(uint32_t asid, uint32_t virtualPage);
+    void flush();
+    void switchTo(uint32_t asid);
+
+    // Statistics for vmstat
+    uint64_t getHits() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t getMisses() const { return misses.load(std::memory_order_relaxed); }
+    uint64_t getShootdowns() const { return shootdowns.load(std::memory_order_relaxed); }
+    uint64_t getSwitches() const { return switches.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry
+    {
+        uint32_t asid;
+        uint32_t virtualPage;
+        uint32_t frame;
+        bool isValid;
+        bool isWritable;
+        uint64_t lastUse;
+    };
+
+    Entry entries[SETS][WAYS];
+    uint64_t useClock;
+    uint32_t currentASID;
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> shootdowns;
+    std::atomic<uint64_t> switches;
+
+    static size_t setIndex(uint32_t asid, uint32_t virtualPage)
+    {
+        return (virtualPage ^ (asid * 0x9E3779B1u)) % SETS;
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "WorkloadTrace.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+const char WorkloadTrace::MAGIC[4] = {'C', 'S', 'T', 'R'};
+const uint16_t WorkloadTrace::VERSION;
+const size_t WorkloadTrace::FILE_HEADER_SIZE;
+
+// Longest name accepted when reading, so a corrupt length is caught early
+static const size_t MAX_NAME_LENGTH = 4096;
+
+template <typename T>
+static void put(std::vector<char> &out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+static void putVarint(std::vector<char> &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Bounds-checked reader over the whole trace
+struct TraceReader
+{
+    const char *data;
+    size_t end;
+    size_t offset;
+
+    template <typename T>
+    bool get(T &value)
+    {
+        if (end - offset < sizeof(T))
+            return false;
+
+        uint64_t result = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            result |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8 * i);
+        }
+        value = static_cast<T>(result);
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool getVarint(uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && offset < end; shift += 7)
+        {
+            unsigned char byte = static_cast<unsigned char>(data[offset++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+};
+
+void WorkloadTrace::encodeFileHeader(std::vector<char> &out)
+{
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    put<uint16_t>(out, VERSION);
+    put<uint16_t>(out, 0);
+}
+
+bool WorkloadTrace::decodeFileHeader(const char *data, size_t size)
+{
+    if (size < FILE_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+
+    TraceReader reader = {data, FILE_HEADER_SIZE, sizeof(MAGIC)};
+    uint16_t version = 0;
+    return reader.get(version) && version == VERSION;
+}
+
+void WorkloadTrace::encode(const Admission &admission, uint64_t previousCycle, std::vector<char> &out)
+{
+    putVarint(out, admission.cycle - previousCycle);
+    putVarint(out, admission.instructionCount);
+    putVarint(out, admission.memoryRequirement);
+    put<uint64_t>(out, admission.programSeed);
+    putVarint(out, admission.name.size());
+    out.insert(out.end(), admission.name.begin(), admission.name.end());
+}
+
+bool WorkloadTrace::decode(const char *data, size_t size, size_t &offset, uint64_t previousCycle,
+                           Admission &admission)
+{
+    TraceReader reader = {data, size, offset};
+    uint64_t cycleDelta, instructions, memory, nameLength;
+    if (!reader.getVarint(cycleDelta) || !reader.getVarint(instructions) || !reader.getVarint(memory) ||
+        !reader.get(admission.programSeed) || !reader.getVarint(nameLength))
+        return false;
+
+    if (instructions > UINT32_MAX || memory > UINT32_MAX || nameLength == 0 || nameLength > MAX_NAME_LENGTH ||
+        nameLength > size - reader.offset)
+        return false;
+
+    admission.cycle = previousCycle + cycleDelta;
+    admission.instructionCount = static_cast<uint32_t>(instructions);
+    admission.memoryRequirement = static_cast<uint32_t>(memory);
+    admission.name.assign(data + reader.offset, nameLength);
+    offset = reader.offset + nameLength;
+    return true;
+}
+
+std::vector<WorkloadTrace::Admission> WorkloadTrace::load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not open trace file: " + path);
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!decodeFileHeader(data.data(), data.size()))
+    {
+        throw std::runtime_error("Not a workload trace: " + path);
+    }
+
+    std::vector<Admission> admissions;
+    size_t offset = FILE_HEADER_SIZE;
+    uint64_t cycle = 0;
+    while (offset < data.size())
+    {
+        Admission admission;
+        if (!decode(data.data(), data.size(), offset, cycle, admission))
+        {
+            throw std::runtime_error("Malformed record in trace file: " + path);
+        }
+        cycle = admission.cycle;
+        admissions.push_back(std::move(admission));
+    }
+    return admissions;
+}
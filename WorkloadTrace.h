@@ -0,0 +1,49 @@
+#ifndef WORKLOAD_TRACE_H
+#define WORKLOAD_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Log of process admissions, written as processes are admitted when
+// trace-file is set and read back by the replay command. Varints are
+// LEB128; fixed-width integers are little endian.
+//
+//   file:    "CSTR", u16 version, u16 reserved, records...
+//   record:  varint cycles since the previous record
+//            varint instruction count, varint memory requirement in KB
+//            u64 program seed
+//            varint name length, name bytes
+struct WorkloadTrace
+{
+    static const char MAGIC[4];
+    static const uint16_t VERSION = 1;
+    static const size_t FILE_HEADER_SIZE = 8;
+
+    struct Admission
+    {
+        uint64_t cycle;
+        std::string name;
+        uint32_t instructionCount;
+        uint32_t memoryRequirement; // KB
+        uint64_t programSeed;
+    };
+
+    static void encodeFileHeader(std::vector<char> &out);
+    static bool decodeFileHeader(const char *data, size_t size);
+
+    // Appends one record, with its cycle stored relative to previousCycle
+    static void encode(const Admission &admission, uint64_t previousCycle, std::vector<char> &out);
+
+    // Parses the record at offset and advances past it; false on a
+    // truncated or malformed record
+    static bool decode(const char *data, size_t size, size_t &offset, uint64_t previousCycle,
+                       Admission &admission);
+
+    // Reads every admission in a trace file; throws std::runtime_error if
+    // the file cannot be read or is malformed
+    static std::vector<Admission> load(const std::string &path);
+};
+
+#endif
@@ -0,0 +1,27 @@
+#include "Xoshiro256.h"
+#include <random>
+
+// The state is filled from splitmix64 so that nearby seeds, including
+// zero, still give well-mixed and distinct streams
+Xoshiro256::Xoshiro256(uint64_t seed)
+{
+    for (auto &word : state)
+    {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+Xoshiro256::Xoshiro256(uint64_t seed, uint64_t stream) : Xoshiro256(seed ^ Xoshiro256(stream)())
+{
+}
+
+Xoshiro256 &Xoshiro256::local()
+{
+    thread_local Xoshiro256 generator((static_cast<uint64_t>(std::random_device()()) << 32) |
+                                      std::random_device()());
+    return generator;
+}
@@ -0,0 +1,46 @@
+#ifndef XOSHIRO256_H
+#define XOSHIRO256_H
+
+#include <cstdint>
+
+// xoshiro256** generator: four words of state and a few shifts and rotates
+// per number, against mt19937's 2.5KB of state and the system call behind
+// each std::random_device. Works with the standard distributions.
+class Xoshiro256
+{
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t seed);
+
+    // Independent generator for one stream of a seeded run, such as one
+    // per PID, so a stream's numbers do not depend on how many other
+    // streams have drawn before it
+    Xoshiro256(uint64_t seed, uint64_t stream);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()()
+    {
+        uint64_t result = rotate(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate(state[3], 45);
+        return result;
+    }
+
+    // The calling thread's generator, seeded once from std::random_device
+    static Xoshiro256 &local();
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+#endif
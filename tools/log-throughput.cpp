@@ -0,0 +1,106 @@
+// Measures how many print lines the process logger sustains. One producer
+// thread per core calls ProcessLogger::log as fast as it can for the given
+// time, then the logger is shut down so every accepted record is written.
+// The core count, log-output and log-file come from the config file; use
+// num-cpu 64 to match the largest configurations. On a machine with fewer
+// hardware threads than producers the figures mostly reflect scheduling,
+// so compare runs on the same host.
+//
+// Build from the repository root:
+//   g++ -std=c++11 -O2 -pthread -o log-throughput tools/log-throughput.cpp ProcessLogger.cpp LogStore.cpp Config.cpp
+//
+// Usage:
+//   log-throughput <config-file> [seconds]
+//
+// The default run lasts 5 seconds.
+
+#include "../ProcessLogger.h"
+#include "../Config.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int PROCESSES_PER_CORE = 16;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <config-file> [seconds]\n";
+        return 1;
+    }
+
+    double seconds = argc > 2 ? std::atof(argv[2]) : 5.0;
+
+    try
+    {
+        Config::getInstance().loadConfig(argv[1]);
+    }
+    catch (const Config::ConfigException &e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    int cores = Config::getInstance().getNumCPU();
+    ProcessLogger &logger = ProcessLogger::getInstance();
+    for (int pid = 1; pid <= cores * PROCESSES_PER_CORE; ++pid)
+    {
+        logger.registerProcess(pid, "process" + std::to_string(pid));
+    }
+    logger.initialize();
+    if (!logger.isEnabled())
+    {
+        std::cerr << "log-output is off\n";
+        return 1;
+    }
+
+    std::atomic<bool> running(true);
+    std::vector<uint64_t> attempts(cores, 0);
+    std::vector<std::thread> producers;
+    auto start = std::chrono::steady_clock::now();
+    for (int core = 0; core < cores; ++core)
+    {
+        producers.emplace_back([&, core]()
+                               {
+            uint64_t count = 0;
+            int pid = core * PROCESSES_PER_CORE + 1;
+            while (running.load(std::memory_order_relaxed))
+            {
+                logger.log(core, pid + static_cast<int>(count % PROCESSES_PER_CORE));
+                ++count;
+            }
+            attempts[core] = count; });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    logger.shutdown();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t total = 0;
+    for (uint64_t count : attempts)
+    {
+        total += count;
+    }
+    uint64_t written = logger.getLinesWritten();
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "Producers:      " << cores << "\n"
+              << "Log calls:      " << total << " (" << total / elapsed << "/s)\n"
+              << "Lines written:  " << written << " (" << written / elapsed << "/s)\n"
+              << "Dropped:        " << total - written << "\n"
+              << "Batches:        " << logger.getBatchesWritten() << "\n"
+              << "Bytes written:  " << logger.getBytesWritten() << "\n";
+    return 0;
+}
@@ -0,0 +1,246 @@
+// Measures cache line contention on Process fields: one writer thread per
+// core ticks its own process while monitor threads keep scanning every
+// process, the way screen -ls and process-smi do. It compares the old
+// packed layout, with the hot atomics next to the identification fields,
+// against the hot/cold split that Process now uses, and against the same
+// split with the hot block padded out to its own cache line. The layouts
+// are mirrored here so the benchmark builds without the rest of the
+// emulator.
+//
+// Build from the repository root:
+//   g++ -std=c++11 -O2 -pthread -o process-contention tools/process-contention.cpp
+//
+// Usage:
+//   process-contention [cores] [ticks-per-core] [monitors]
+//
+// Defaults are 64 cores, 2000000 ticks and 4 monitor threads.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t CACHE_LINE_SIZE = 64;
+
+enum ProcessState
+{
+    READY,
+    RUNNING,
+    WAITING,
+    FINISHED
+};
+
+// Field order of Process before the split
+struct PackedProcess
+{
+    const int pid;
+    const std::string name;
+    std::atomic<ProcessState> state;
+    std::atomic<int> cpuCoreID;
+    size_t memoryRequirement;
+    std::atomic<int> commandCounter;
+    std::atomic<uint32_t> quantumTime;
+    std::mutex processMutex;
+
+    PackedProcess(int pid, const std::string &name)
+        : pid(pid), name(name), state(RUNNING), cpuCoreID(0), memoryRequirement(4096), commandCounter(0), quantumTime(0) {}
+
+    std::atomic<int> &counter() { return commandCounter; }
+    std::atomic<uint32_t> &quantum() { return quantumTime; }
+    std::atomic<ProcessState> &status() { return state; }
+    size_t identify() const { return pid + memoryRequirement + name.size(); }
+};
+
+struct HotFields
+{
+    std::atomic<ProcessState> state;
+    std::atomic<int> cpuCoreID;
+    std::atomic<int> commandCounter;
+    std::atomic<uint32_t> quantumTime;
+};
+
+struct ColdFields
+{
+    std::string name;
+    std::mutex processMutex;
+};
+
+// Field order of Process after the split
+struct SplitProcess
+{
+    const int pid;
+    size_t memoryRequirement;
+    std::unique_ptr<ColdFields> cold;
+    HotFields hot;
+
+    SplitProcess(int pid, const std::string &name)
+        : pid(pid), memoryRequirement(4096), cold(new ColdFields)
+    {
+        cold->name = name;
+        hot.state = RUNNING;
+        hot.cpuCoreID = 0;
+        hot.commandCounter = 0;
+        hot.quantumTime = 0;
+    }
+
+    std::atomic<int> &counter() { return hot.commandCounter; }
+    std::atomic<uint32_t> &quantum() { return hot.quantumTime; }
+    std::atomic<ProcessState> &status() { return hot.state; }
+    size_t identify() const { return pid + memoryRequirement + cold->name.size(); }
+};
+
+// The split with the hot block padded on both sides, since operator new
+// does not honour over-aligned types before C++17
+struct PaddedProcess
+{
+    const int pid;
+    size_t memoryRequirement;
+    std::unique_ptr<ColdFields> cold;
+    char hotPaddingBefore[CACHE_LINE_SIZE];
+    HotFields hot;
+    char hotPaddingAfter[CACHE_LINE_SIZE - sizeof(HotFields) % CACHE_LINE_SIZE];
+
+    PaddedProcess(int pid, const std::string &name)
+        : pid(pid), memoryRequirement(4096), cold(new ColdFields)
+    {
+        cold->name = name;
+        hot.state = RUNNING;
+        hot.cpuCoreID = 0;
+        hot.commandCounter = 0;
+        hot.quantumTime = 0;
+    }
+
+    std::atomic<int> &counter() { return hot.commandCounter; }
+    std::atomic<uint32_t> &quantum() { return hot.quantumTime; }
+    std::atomic<ProcessState> &status() { return hot.state; }
+    size_t identify() const { return pid + memoryRequirement + cold->name.size(); }
+};
+
+struct Result
+{
+    double tickNanos;     // Average time per tick on a core
+    double scansPerSecond; // Full process table scans by all monitors
+};
+
+template <typename ProcessType>
+Result run(size_t cores, uint64_t ticks, size_t monitors)
+{
+    // Allocated back to back, as the scheduler creates them in bursts
+    std::vector<std::unique_ptr<ProcessType>> processes;
+    for (size_t i = 0; i < cores; ++i)
+    {
+        processes.push_back(std::unique_ptr<ProcessType>(new ProcessType(static_cast<int>(i), "process" + std::to_string(i))));
+    }
+
+    std::atomic<bool> start(false);
+    std::atomic<size_t> coresRunning(cores);
+    std::atomic<uint64_t> scans(0);
+    std::vector<double> tickNanos(cores);
+    std::vector<std::thread> threads;
+
+    for (size_t core = 0; core < cores; ++core)
+    {
+        threads.emplace_back([&, core]
+                             {
+            ProcessType &process = *processes[core];
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            auto begin = std::chrono::steady_clock::now();
+            for (uint64_t tick = 0; tick < ticks; ++tick)
+            {
+                process.counter().fetch_add(1, std::memory_order_relaxed);
+                process.quantum().fetch_add(1, std::memory_order_relaxed);
+            }
+            auto elapsed = std::chrono::steady_clock::now() - begin;
+            tickNanos[core] = std::chrono::duration<double, std::nano>(elapsed).count() / ticks;
+            coresRunning.fetch_sub(1, std::memory_order_release); });
+    }
+
+    size_t checksum = 0;
+    std::mutex checksumMutex;
+    for (size_t monitor = 0; monitor < monitors; ++monitor)
+    {
+        threads.emplace_back([&]
+                             {
+            size_t local = 0;
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            while (coresRunning.load(std::memory_order_acquire) > 0)
+            {
+                for (auto &process : processes)
+                {
+                    local += process->identify();
+                    if (process->status().load(std::memory_order_relaxed) == RUNNING)
+                        local += process->counter().load(std::memory_order_relaxed);
+                }
+                scans.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> lock(checksumMutex);
+            checksum += local; });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    Result result;
+    result.tickNanos = 0;
+    for (double nanos : tickNanos)
+    {
+        result.tickNanos += nanos / cores;
+    }
+    result.scansPerSecond = scans.load() / seconds;
+
+    // Keeps the monitor reads from being optimised away
+    if (checksum == 1)
+        std::cerr << "";
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t cores = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    uint64_t ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+    size_t monitors = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+    if (cores == 0 || ticks == 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [cores] [ticks-per-core] [monitors]\n";
+        return 1;
+    }
+
+    std::cout << cores << " cores, " << ticks << " ticks each, " << monitors << " monitors, "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << "sizeof: packed=" << sizeof(PackedProcess) << ", split=" << sizeof(SplitProcess)
+              << ", padded=" << sizeof(PaddedProcess) << " + " << sizeof(ColdFields) << " cold\n\n";
+
+    Result packed = run<PackedProcess>(cores, ticks, monitors);
+    Result split = run<SplitProcess>(cores, ticks, monitors);
+    Result padded = run<PaddedProcess>(cores, ticks, monitors);
+
+    std::cout << std::left << std::setw(10) << "layout" << std::setw(14) << "ns/tick" << std::setw(14) << "scans/s"
+              << "tick speedup\n";
+    const char *names[] = {"packed", "split", "padded"};
+    const Result *results[] = {&packed, &split, &padded};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(10) << names[i]
+                  << std::setw(14) << results[i]->tickNanos << std::setprecision(0) << std::setw(14)
+                  << results[i]->scansPerSecond << std::setprecision(2)
+                  << packed.tickNanos / results[i]->tickNanos << "x\n";
+    }
+    return 0;
+}
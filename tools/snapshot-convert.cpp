@@ -0,0 +1,156 @@
+// Converts the binary memory-map snapshots written when snapshot-interval
+// is set into a readable report or CSV.
+//
+// Build from the repository root:
+//   g++ -std=c++11 -o snapshot-convert tools/snapshot-convert.cpp MemorySnapshot.cpp
+//
+// Usage:
+//   snapshot-convert <snapshot-file> [--csv]
+//
+// The text report draws one character per frame: '.' free, '#' private,
+// 'S' shared, 'H' part of a huge frame, 'T' in transit. CSV output has one row per frame, process
+// and block, with the columns a row type does not use left empty.
+
+#include "../MemorySnapshot.h"
+#include "../FrameTable.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static const size_t FRAMES_PER_LINE = 64;
+
+static char frameSymbol(const MemorySnapshot::Frame &frame)
+{
+    if (frame.flags & FrameTable::IN_TRANSIT)
+        return 'T';
+    if (!(frame.flags & FrameTable::PRESENT))
+        return '.';
+    if (frame.flags & FrameTable::HUGE)
+        return 'H';
+    return (frame.flags & FrameTable::SHARED) ? 'S' : '#';
+}
+
+static void printText(const MemorySnapshot &snapshot)
+{
+    std::cout << "=== Cycle " << snapshot.cycle << " ("
+              << (snapshot.isPaged ? "paged, " + std::to_string(snapshot.pageSize / 1024) + "KB frames" : "flat")
+              << ") ===\n";
+    std::cout << "Memory: " << snapshot.usedBytes / 1024 << "KB / " << snapshot.totalBytes / 1024 << "KB used"
+              << ", largest free " << snapshot.largestFreeBlock / 1024 << "KB";
+    if (!snapshot.isPaged)
+    {
+        std::cout << ", internal fragmentation " << snapshot.internalFragmentation / 1024 << "KB"
+                  << ", external fragmentation " << std::fixed << std::setprecision(2)
+                  << snapshot.externalFragmentation / 100.0 << "%";
+    }
+    std::cout << "\n";
+
+    for (size_t i = 0; i < snapshot.frames.size(); ++i)
+    {
+        if (i % FRAMES_PER_LINE == 0)
+            std::cout << (i == 0 ? "" : "\n") << std::setw(6) << i << "  ";
+        std::cout << frameSymbol(snapshot.frames[i]);
+    }
+    if (!snapshot.frames.empty())
+        std::cout << "\n";
+
+    for (const auto &block : snapshot.blocks)
+    {
+        std::cout << "  [0x" << std::hex << std::setw(8) << std::setfill('0') << block.address << std::dec
+                  << std::setfill(' ') << "] " << std::setw(8) << block.size / 1024 << "KB "
+                  << (block.isFree ? "free" : "used") << "\n";
+    }
+
+    for (const auto &process : snapshot.processes)
+    {
+        std::cout << "  pid " << std::setw(5) << process.pid << "  " << process.size / 1024 << "KB";
+        if (snapshot.isPaged)
+        {
+            std::cout << ", resident " << process.residentPages << " pages"
+                      << ", working set " << process.workingSet;
+        }
+        else
+        {
+            std::cout << " at 0x" << std::hex << process.address << std::dec;
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\n";
+}
+
+static void printCSVHeader()
+{
+    std::cout << "cycle,type,id,flags,owner,page,address,size,free,resident,working_set\n";
+}
+
+static void printCSV(const MemorySnapshot &snapshot)
+{
+    for (size_t i = 0; i < snapshot.frames.size(); ++i)
+    {
+        const auto &frame = snapshot.frames[i];
+        std::cout << snapshot.cycle << ",frame," << i << "," << static_cast<int>(frame.flags) << ","
+                  << frame.owner << "," << frame.pageNumber << ",,,,,\n";
+    }
+    for (const auto &process : snapshot.processes)
+    {
+        std::cout << snapshot.cycle << ",process," << process.pid << ",,,," << process.address << ","
+                  << process.size << ",," << process.residentPages << "," << process.workingSet << "\n";
+    }
+    for (size_t i = 0; i < snapshot.blocks.size(); ++i)
+    {
+        const auto &block = snapshot.blocks[i];
+        std::cout << snapshot.cycle << ",block," << i << ",,,," << block.address << "," << block.size << ","
+                  << (block.isFree ? 1 : 0) << ",,\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3 || (argc == 3 && std::string(argv[2]) != "--csv"))
+    {
+        std::cerr << "Usage: " << argv[0] << " <snapshot-file> [--csv]\n";
+        return 1;
+    }
+    bool csv = argc == 3;
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Could not open " << argv[1] << "\n";
+        return 1;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!MemorySnapshot::decodeFileHeader(data.data(), data.size()))
+    {
+        std::cerr << argv[1] << " is not a version " << MemorySnapshot::VERSION << " snapshot file\n";
+        return 1;
+    }
+
+    if (csv)
+        printCSVHeader();
+
+    size_t offset = MemorySnapshot::FILE_HEADER_SIZE;
+    size_t count = 0;
+    MemorySnapshot snapshot;
+    while (offset < data.size())
+    {
+        // The emulator may have been stopped mid-write; keep what was complete
+        if (!snapshot.decode(data.data(), data.size(), offset))
+        {
+            std::cerr << "Truncated record after " << count << " snapshots\n";
+            break;
+        }
+
+        if (csv)
+            printCSV(snapshot);
+        else
+            printText(snapshot);
+        ++count;
+    }
+
+    return 0;
+}